@@ -1,5 +1,9 @@
+#include <fstream>
+
 #include "Finite/Automaton/CDFA.hpp"
+#include "Finite/Automaton/CodeGenerator.hpp"
 #include "Finite/Automaton/DFA.hpp"
+#include "Finite/Automaton/Matcher.hpp"
 #include "Finite/Automaton/NFA.hpp"
 #include "Finite/Expression/Expression.hpp"
 #include "Pushdown/Parser/ParserEarley.hpp"
@@ -33,6 +37,9 @@ void notifyUsage() {
       "----> ntod: Transform an automaton to a DFA\n"
       "----> ntoc: Transform an automaton to a CDFA\n"
       "----> ator: Transform an automaton to a regular expression\n"
+      "----> rtob: Compile a regular expression to a binary CDFA file\n"
+      "----> bchk: Use a compiled binary CDFA file to check if a word can be recognized\n"
+      "----> rtog: Generate a C++ matcher source file from a regular expression\n"
       "--> Pushdown context-free automaton was selected\n"
       "----> erly: Use Earley's algorithm to check if a word can be recognized\n"
       "----> alr1: Use LR-1 algorithm to check if a word can be recognized\n";
@@ -161,6 +168,48 @@ void finiteATOR() {
   std::cout << Expression(readNFA()) << '\n';
 }
 
+void finiteRTOB() {
+  notify("-----Compiling a regular expression to a binary CDFA file-----\n\n");
+  Expression expression = readExpression();
+
+  std::string path;
+  communicate("Enter an output file path: ", path);
+  CDFA(expression).save(path);
+  notify("Saved to " + path + "\n");
+}
+
+void finiteBCHK() {
+  notify("-----Using a compiled binary CDFA file to check if a word can be recognized-----\n\n");
+  std::string path;
+  communicate("Enter a compiled file path: ", path);
+  Matcher matcher = Matcher::load(path);
+
+  size_t nword;
+  communicate("Enter a number of words: ", nword);
+  while (nword-- > 0) {
+    std::string word;
+    communicate("Enter a word: ", word);
+    notify(matcher.checkWord(word) ? "Result: Yes\n" : "Result: No\n");
+  }
+}
+
+void finiteRTOG() {
+  notify("-----Generating a C++ matcher from a regular expression-----\n\n");
+  Expression expression = readExpression();
+
+  std::string function;
+  communicate("Enter a matcher function name: ", function);
+  std::string path;
+  communicate("Enter an output file path: ", path);
+
+  std::ofstream out(path);
+  CodeGenerator(CDFA(expression)).generate(out, function);
+  if (!out.flush()) {
+    throw std::runtime_error("Cannot write file " + path);
+  }
+  notify("Saved to " + path + "\n");
+}
+
 void pushdownParser(Parser* parser) {
   parser->fit(readGrammar());
 
@@ -200,6 +249,12 @@ void processFinite(const std::string& task) {
     finiteNTOC();
   } else if (task == "ator") {
     finiteATOR();
+  } else if (task == "rtob") {
+    finiteRTOB();
+  } else if (task == "bchk") {
+    finiteBCHK();
+  } else if (task == "rtog") {
+    finiteRTOG();
   } else {
     notifyUsage();
     throw std::invalid_argument("Invalid option!");
@@ -0,0 +1,357 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : BenchFinite.cpp
+ ******************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "AntichainChecker.hpp"
+#include "CDFA.hpp"
+#include "DFA.hpp"
+#include "Expression.hpp"
+#include "LazyDFA.hpp"
+#include "Matcher.hpp"
+#include "NFASimulator.hpp"
+#include "NFA.hpp"
+#include "PatternSet.hpp"
+
+NFA randomDeterministicNFA(size_t size, const std::string& alphabet, unsigned seed) {
+  std::mt19937 gen(seed);
+  NFA nfa(size, alphabet);
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    for (char symb : alphabet) {
+      nfa.addTransition({vertex, std::string(1, symb), gen() % size});
+    }
+    if (gen() % 2 == 0) {
+      nfa.addFinalState(vertex);
+    }
+  }
+  return nfa;
+}
+
+NFA randomEpsilonNFA(size_t size, unsigned seed) {
+  std::mt19937 gen(seed);
+  NFA nfa(size, "ab");
+  for (size_t vertex = 0; vertex + 1 < size; ++vertex) {
+    nfa.addTransition(vertex, gen() % 2 == 0 ? "" : (gen() % 2 == 0 ? "a" : "b"), vertex + 1);
+    if (gen() % 8 == 0) {
+      nfa.addTransition(vertex, "", vertex - std::min<size_t>(vertex, gen() % 8));
+    }
+  }
+  nfa.addFinalState(size - 1);
+  return nfa;
+}
+
+std::string randomWordsExpression(size_t count, size_t length, const std::string& alphabet, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::string res;
+  for (size_t index = 0; index < count; ++index) {
+    res += index == 0 ? "" : "+";
+    for (size_t pos = 0; pos < length; ++pos) {
+      res += pos == 0 ? "" : ".";
+      res += alphabet[gen() % alphabet.size()];
+    }
+  }
+  return res;
+}
+
+std::string nthFromEndExpression(size_t n) {
+  std::string res = "(a+b)*.a";
+  for (size_t index = 0; index < n; ++index) {
+    res += ".(a+b)";
+  }
+  return res;
+}
+
+std::vector<std::string> randomWords(size_t count, size_t length, const std::string& alphabet, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<std::string> res(count);
+  for (auto& word : res) {
+    for (size_t pos = 0; pos < length; ++pos) {
+      word.push_back(alphabet[gen() % alphabet.size()]);
+    }
+  }
+  return res;
+}
+
+void BM_Minimize(benchmark::State& state) {
+  CDFA cdfa(randomDeterministicNFA(state.range(0), "ab", 42));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cdfa.minimize());
+  }
+  state.counters["states"] = cdfa.getSize();
+}
+
+BENCHMARK(BM_Minimize)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+
+void BM_ThrowEpsilon(benchmark::State& state) {
+  NFA nfa = randomEpsilonNFA(state.range(0), 42);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(nfa.throwEpsilon());
+  }
+}
+
+BENCHMARK(BM_ThrowEpsilon)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+void BM_ExpressionToNFA(benchmark::State& state) {
+  Expression expression(randomWordsExpression(state.range(0), 10, "abcd", 42));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(expression.toNFA());
+  }
+}
+
+BENCHMARK(BM_ExpressionToNFA)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+
+void BM_AccumulateUnion(benchmark::State& state) {
+  std::vector<NFA> words;
+  for (const auto& word : randomWords(state.range(0), 10, "abcd", 42)) {
+    std::string str;
+    for (char symb : word) {
+      str += str.empty() ? "" : ".";
+      str += symb;
+    }
+    words.emplace_back(Expression(str));
+  }
+  for (auto _ : state) {
+    NFA accumulator(0, "");
+    for (const auto& word : words) {
+      accumulator += word;
+    }
+    benchmark::DoNotOptimize(accumulator);
+  }
+}
+
+BENCHMARK(BM_AccumulateUnion)->RangeMultiplier(4)->Range(1024, 16384)->Unit(benchmark::kMillisecond);
+
+void BM_ExpressionToDFA(benchmark::State& state) {
+  std::string patterns[] = {randomWordsExpression(256, 10, "abcd", 42), nthFromEndExpression(10),
+                            "(a+b+c+d)*.(a.b.c + b.c.d)*.(a+b)*.d.(c+d)*"};
+  Expression expression(patterns[state.range(0)]);
+  auto construction = static_cast<Expression::Construction>(state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DFA(expression, construction));
+  }
+  state.counters["states"] = DFA(expression, construction).getSize();
+}
+
+BENCHMARK(BM_ExpressionToDFA)->ArgsProduct({{0, 1, 2}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+void BM_ToExpression(benchmark::State& state) {
+  NFA nfa = randomDeterministicNFA(state.range(0), "ab", 42);
+  auto order = static_cast<Expression::Elimination>(state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Expression(nfa, order));
+  }
+  if (state.range(0) <= 32) {
+    state.counters["length"] = Expression(nfa, order).toString().size();
+  }
+}
+
+BENCHMARK(BM_ToExpression)->ArgsProduct({{8, 16, 24, 256}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+void BM_Combine(benchmark::State& state) {
+  CDFA left(randomDeterministicNFA(state.range(0), "abc", 42));
+  CDFA right(Expression("(a+b+c)*.a.b.(a+b+c)*.c"));
+  auto operation = static_cast<CDFA::Operation>(state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CDFA::combine(left, right, operation, state.range(2) == 1));
+  }
+  state.counters["states"] = CDFA::combine(left, right, operation, state.range(2) == 1).getSize();
+}
+
+BENCHMARK(BM_Combine)->ArgsProduct({{1024, 16384}, {0, 1}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_Equivalent(benchmark::State& state) {
+  CDFA left(randomDeterministicNFA(state.range(0), "abc", 42));
+  CDFA right = CDFA::combine(left, left, CDFA::Operation::Union, false);
+  bool unionFind = state.range(1) == 0;
+  for (auto _ : state) {
+    if (unionFind) {
+      benchmark::DoNotOptimize(CDFA::equivalent(left, right));
+    } else {
+      benchmark::DoNotOptimize(left.minimize().getTransitions() == right.minimize().getTransitions());
+    }
+  }
+}
+
+BENCHMARK(BM_Equivalent)->ArgsProduct({{1024, 16384}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_Inclusion(benchmark::State& state) {
+  NFA container(Expression(nthFromEndExpression(state.range(0))));
+  NFA contained(Expression("(a+b)*.a.a" + nthFromEndExpression(state.range(0) - 1).substr(8)));
+  bool antichain = state.range(1) == 0;
+  for (auto _ : state) {
+    if (antichain) {
+      benchmark::DoNotOptimize(AntichainChecker(container).includes(contained));
+    } else {
+      benchmark::DoNotOptimize(CDFA::includes(CDFA(container), CDFA(contained)));
+    }
+  }
+}
+
+BENCHMARK(BM_Inclusion)->ArgsProduct({{8, 12, 16}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_Complete(benchmark::State& state) {
+  DFA dfa(randomDeterministicNFA(state.range(0), "abcd", 42));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CDFA(dfa));
+  }
+  state.counters["states"] = dfa.getSize();
+}
+
+BENCHMARK(BM_Complete)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+
+void BM_DeterminizeWords(benchmark::State& state) {
+  NFA nfa(Expression(randomWordsExpression(state.range(0), 10, "abcd", 42)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DFA(nfa));
+  }
+  state.counters["nfa"] = nfa.getSize();
+}
+
+BENCHMARK(BM_DeterminizeWords)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+
+void BM_DeterminizeBlowup(benchmark::State& state) {
+  NFA nfa(Expression(nthFromEndExpression(state.range(0))));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DFA(nfa));
+  }
+  state.counters["nfa"] = nfa.getSize();
+}
+
+BENCHMARK(BM_DeterminizeBlowup)->DenseRange(4, 12, 4)->Unit(benchmark::kMillisecond);
+
+void BM_DeterminizeReduce(benchmark::State& state) {
+  NFA nfa(Expression(state.range(0) == 0 ? randomWordsExpression(256, 10, "abcd", 42) : nthFromEndExpression(12)));
+  DeterminizeOptions options{.reduce = static_cast<DeterminizeOptions::Reduction>(state.range(1))};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DFA(nfa, options));
+  }
+  state.counters["states"] = DFA(nfa, options).getSize();
+}
+
+BENCHMARK(BM_DeterminizeReduce)->ArgsProduct({{0, 1}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+void BM_LazyBlowup(benchmark::State& state) {
+  LazyDFA lazy(NFA(Expression(nthFromEndExpression(state.range(0)))));
+  auto words = randomWords(256, 1024, "ab", 42);
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      benchmark::DoNotOptimize(lazy.checkWord(word));
+    }
+  }
+  state.counters["cached"] = lazy.getCachedSize();
+  state.SetBytesProcessed(state.iterations() * words.size() * words[0].size());
+}
+
+BENCHMARK(BM_LazyBlowup)->DenseRange(4, 24, 10)->Unit(benchmark::kMillisecond);
+
+void BM_DeterminizeParallel(benchmark::State& state) {
+  NFA nfa(Expression(nthFromEndExpression(14)));
+  DeterminizeOptions options{static_cast<size_t>(state.range(0))};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DFA(nfa, options));
+  }
+}
+
+BENCHMARK(BM_DeterminizeParallel)->RangeMultiplier(2)->Range(1, 32)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_CheckWordDFA(benchmark::State& state) {
+  DFA dfa(NFA(Expression(nthFromEndExpression(state.range(0)))));
+  auto words = randomWords(256, 1024, "ab", 42);
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      benchmark::DoNotOptimize(dfa.checkWord(word));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * words.size() * words[0].size());
+}
+
+BENCHMARK(BM_CheckWordDFA)->DenseRange(4, 14, 5)->Unit(benchmark::kMillisecond);
+
+void BM_CheckWordSimulator(benchmark::State& state) {
+  NFASimulator simulator(NFA(Expression(nthFromEndExpression(state.range(0)))));
+  auto words = randomWords(256, 1024, "ab", 42);
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      benchmark::DoNotOptimize(simulator.checkWord(word));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * words.size() * words[0].size());
+}
+
+BENCHMARK(BM_CheckWordSimulator)->DenseRange(4, 14, 5)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+void BM_CheckWords(benchmark::State& state) {
+  Matcher matcher(CDFA(randomDeterministicNFA(1 << 18, "abcd", 42)));
+  auto words = randomWords(1 << 16, 16, "abcd", 7);
+  std::vector<std::string_view> views(words.begin(), words.end());
+  auto kernel = static_cast<Matcher::Kernel>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matcher.checkWords(views, kernel));
+  }
+  state.counters["states"] = matcher.getSize();
+  state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+BENCHMARK(BM_CheckWords)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+void BM_MatchPatterns(benchmark::State& state) {
+  auto suffixes = randomWords(200, 6, "abcd", 11);
+  auto words = randomWords(1 << 12, 16, "abcd", 12);
+  PatternSet patterns;
+  std::vector<Matcher> matchers;
+  for (const auto& suffix : suffixes) {
+    std::string expression = "(a+b+c+d)*";
+    for (char symb : suffix) {
+      expression += std::string(".") + symb;
+    }
+    patterns.add(Expression(expression));
+    matchers.emplace_back(CDFA(Expression(expression)));
+  }
+  Matcher combined{CDFA(patterns.toNFA())};
+
+  bool separate = state.range(0) == 0;
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      if (separate) {
+        std::vector<size_t> res;
+        for (size_t index = 0; index < matchers.size(); ++index) {
+          if (matchers[index].checkWord(word)) {
+            res.push_back(index);
+          }
+        }
+        benchmark::DoNotOptimize(res);
+      } else {
+        benchmark::DoNotOptimize(combined.matchPatterns(word));
+      }
+    }
+  }
+  state.counters["states"] = combined.getSize();
+  state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+BENCHMARK(BM_MatchPatterns)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+
+bool matchLoop(const char* data, std::size_t size);
+bool matchNthFromEnd(const char* data, std::size_t size);
+
+void BM_MatchGenerated(benchmark::State& state) {
+  bool loop = state.range(0) == 0;
+  std::string text = randomWords(1, 1 << 20, loop ? "abc" : "ab", 3)[0] + (loop ? "d" : "");
+  Matcher matcher(CDFA(Expression(loop ? "(a+b+c)*.d" : nthFromEndExpression(8))));
+  bool generated = state.range(1) == 1;
+  for (auto _ : state) {
+    if (generated) {
+      benchmark::DoNotOptimize(loop ? matchLoop(text.data(), text.size()) : matchNthFromEnd(text.data(), text.size()));
+    } else {
+      benchmark::DoNotOptimize(matcher.checkWord(text));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_MatchGenerated)->ArgsProduct({{0, 1}, {0, 1}})->Unit(benchmark::kMicrosecond);
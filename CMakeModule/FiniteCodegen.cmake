@@ -0,0 +1,46 @@
+# Generates a C++ matcher from a regular expression at build time.
+#
+# USAGE:
+#   include(FiniteCodegen)
+#   finite_generate_matcher(
+#     TARGET my_target                 # Target that gets the generated source
+#     EXPRESSION "(a+b)*.a.b.b"        # Regular expression in the Automaton syntax
+#     FUNCTION matchABB                # Name of the generated bool(const char*, std::size_t) function
+#     OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/MatchABB.cpp
+#   )
+#
+# The generator is the Automaton executable (task "rtog"). This file is also run
+# in script mode by the generated build rule.
+
+if(CMAKE_SCRIPT_MODE_FILE)
+  file(WRITE ${OUTPUT}.input "${EXPRESSION}\n${FUNCTION}\n${OUTPUT}\n")
+  execute_process(
+    COMMAND ${GENERATOR} -a frla -t rtog
+    INPUT_FILE ${OUTPUT}.input
+    OUTPUT_QUIET
+    RESULT_VARIABLE result
+  )
+  file(REMOVE ${OUTPUT}.input)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Cannot generate a matcher for ${EXPRESSION}")
+  endif()
+  return()
+endif()
+
+function(finite_generate_matcher)
+  cmake_parse_arguments(ARG "" "TARGET;EXPRESSION;FUNCTION;OUTPUT" "" ${ARGN})
+
+  add_custom_command(
+    OUTPUT ${ARG_OUTPUT}
+    COMMAND ${CMAKE_COMMAND}
+      -DGENERATOR=$<TARGET_FILE:Automaton>
+      -DEXPRESSION=${ARG_EXPRESSION}
+      -DFUNCTION=${ARG_FUNCTION}
+      -DOUTPUT=${ARG_OUTPUT}
+      -P ${CMAKE_CURRENT_FUNCTION_LIST_FILE}
+    DEPENDS Automaton ${CMAKE_CURRENT_FUNCTION_LIST_FILE}
+    COMMENT "Generating matcher ${ARG_FUNCTION}"
+    VERBATIM
+  )
+  target_sources(${ARG_TARGET} PRIVATE ${ARG_OUTPUT})
+endfunction()
@@ -0,0 +1,40 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : AntichainChecker.hpp
+ ******************************************/
+
+#pragma once
+
+#include "CDFA.hpp"
+#include "SymbolGraph.hpp"
+
+class NFA;
+
+class AntichainChecker {
+ public:
+  explicit AntichainChecker(const NFA& nfa);
+
+  size_t getSize() const;
+
+  CDFA::Comparison isUniversal() const;
+  CDFA::Comparison includes(const NFA& other) const;
+
+ private:
+  struct Macrostate;
+
+  static constexpr size_t kNoMacrostate = std::numeric_limits<size_t>::max();
+
+  SymbolGraph m_graph;
+  std::string m_alphabet;
+
+  CDFA::Comparison explore(const SymbolGraph* other, const std::string& alphabet) const;
+};
+
+struct AntichainChecker::Macrostate {
+  uint32_t state;
+  std::vector<uint32_t> subset;
+  size_t previous;
+  char symbol;
+  bool removed;
+};
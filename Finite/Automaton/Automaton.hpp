@@ -6,21 +6,47 @@
 
 #pragma once
 
+#include <concepts>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class TransitionVisitor {
+ public:
+  template <typename Callable>
+    requires(!std::same_as<std::remove_cvref_t<Callable>, TransitionVisitor> &&
+             std::invocable<Callable&, size_t, std::string_view, size_t>)
+  TransitionVisitor(Callable&& callable)
+      : m_callable(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+        m_invoke([](void* callable, size_t from, std::string_view label, size_t to) {
+          (*static_cast<std::remove_reference_t<Callable>*>(callable))(from, label, to);
+        }) {}
+
+  void operator()(size_t from, std::string_view label, size_t to) const { m_invoke(m_callable, from, label, to); }
+
+ private:
+  void* m_callable;
+  void (*m_invoke)(void*, size_t, std::string_view, size_t);
+};
+
 class Automaton {
  public:
-  virtual std::vector<std::tuple<size_t, std::string, size_t>> getTransitions() const = 0;
+  virtual void forEachTransition(TransitionVisitor visitor) const = 0;
   virtual size_t getSize() const = 0;
-  
+
+  std::vector<std::tuple<size_t, std::string, size_t>> getTransitions() const;
   std::vector<size_t> getFinalStates() const;
   std::string getAlphabet() const;
 
+  bool hasPatterns() const;
+  std::vector<size_t> getPatterns(size_t vertex) const;
+
  protected:
   std::vector<bool> m_final;
+  std::vector<std::vector<size_t>> m_patterns;
   std::string m_alphabet;
 
   Automaton(size_t size, const std::string& alphabet);
@@ -6,37 +6,122 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
 #include "Automaton.hpp"
+#include "Expression.hpp"
 
-class Expression;
 class NFA;
 class DFA;
 
 class CDFA : public Automaton {
  public:
-  explicit CDFA(const Expression& expression);
+  enum class Operation { Intersection, Union, Difference, SymmetricDifference };
+  struct Comparison;
+
+  explicit CDFA(const Expression& expression,
+                Expression::Construction construction = Expression::Construction::Thompson);
   explicit CDFA(const NFA& nfa);
   explicit CDFA(const DFA& dfa);
 
-  std::vector<std::tuple<size_t, std::string, size_t>> getTransitions() const final;
+  static CDFA load(const std::string& path);
+  void save(const std::string& path) const;
+
+  void forEachTransition(TransitionVisitor visitor) const final;
   size_t getSize() const final;
+  size_t getClassCount() const;
 
   CDFA operator~() const;
+  CDFA operator&(const CDFA& other) const;
+  CDFA operator|(const CDFA& other) const;
+  CDFA operator-(const CDFA& other) const;
+  CDFA operator^(const CDFA& other) const;
+
+  static CDFA combine(const CDFA& left, const CDFA& right, Operation operation, bool minimized = true);
+  static Comparison equivalent(const CDFA& left, const CDFA& right);
+  static Comparison includes(const CDFA& container, const CDFA& contained);
 
   CDFA minimize() const;
 
  private:
+  friend class CodeGenerator;
+  friend class Matcher;
+
+  enum class StateKind : uint8_t { Dead, Universal, Other };
+
+  struct Column;
+  struct Step;
   struct EquivalenceRelation;
+  struct Partition;
 
-  std::vector<std::vector<size_t>> m_transitions;
+  static constexpr uint16_t kNoClass = 256;
+  static constexpr size_t kNoState = std::numeric_limits<size_t>::max();
+
+  std::array<uint16_t, 256> m_classes;
+  size_t m_classCount;
+  std::vector<uint32_t> m_transitions;
 
   CDFA(size_t size, const std::string& alphabet);
 
+  size_t getTransition(size_t vertex, size_t symbolClass) const;
+  size_t advance(size_t vertex, uint16_t symbolClass) const;
+  void setTransition(size_t vertex, size_t symbolClass, size_t to);
+
+  void compressAlphabet();
+
+  static std::vector<Column> pairClasses(const CDFA& left, const CDFA& right, std::array<uint16_t, 256>& classes);
+  static std::string buildCounterexample(const std::vector<Step>& steps, size_t last);
+
+  std::vector<StateKind> classifyStates(bool complete) const;
+  static StateKind combineKinds(Operation operation, StateKind left, StateKind right);
+  static bool combineFinal(Operation operation, bool left, bool right);
+
   EquivalenceRelation buildInitialRelation() const;
   EquivalenceRelation findEquivalentStates() const;
 };
 
+struct CDFA::Comparison {
+  bool holds;
+  std::string counterexample;
+};
+
+struct CDFA::Column {
+  uint16_t left;
+  uint16_t right;
+  char symbol;
+};
+
+struct CDFA::Step {
+  size_t left;
+  size_t right;
+  size_t previous;
+  char symbol;
+};
+
 struct CDFA::EquivalenceRelation {
   std::vector<size_t> classIndex;
   std::vector<std::vector<size_t>> equivalenceClasses;
 };
+
+struct CDFA::Partition {
+  struct Block {
+    size_t begin;
+    size_t marked;
+    size_t end;
+  };
+
+  std::vector<size_t> elements;
+  std::vector<size_t> location;
+  std::vector<size_t> blockIndex;
+  std::vector<Block> blocks;
+
+  explicit Partition(const EquivalenceRelation& relation);
+
+  size_t blockSize(size_t block) const;
+
+  void mark(size_t vertex);
+  std::optional<size_t> split(size_t block);
+};
@@ -0,0 +1,40 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : CodeGenerator.hpp
+ ******************************************/
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "CDFA.hpp"
+
+class CodeGenerator {
+ public:
+  explicit CodeGenerator(const CDFA& cdfa);
+
+  void generate(std::ostream& out, const std::string& function = "match") const;
+
+ private:
+  struct Action;
+
+  CDFA m_cdfa;
+  std::vector<bool> m_sink;
+  std::vector<bool> m_universal;
+
+  Action getAction(size_t vertex, unsigned char symb) const;
+
+  void generateState(std::ostream& out, size_t vertex) const;
+};
+
+struct CodeGenerator::Action {
+  enum class Type { Reject, Accept, Loop, Jump };
+
+  Type type;
+  size_t to;
+
+  auto operator<=>(const Action& other) const = default;
+};
@@ -6,21 +6,69 @@
 
 #pragma once
 
+#include <span>
+
 #include "Automaton.hpp"
-  
-class Expression;
+#include "Expression.hpp"
+
 class NFA;
+class StateSetTable;
+class SymbolGraph;
+
+struct DeterminizeOptions {
+  enum class Reduction { Never, OnBlowup, Always };
+
+  size_t threads = 1;
+  size_t stateLimit = 0;
+  Reduction reduce = Reduction::OnBlowup;
+};
 
 class DFA : public Automaton {
  public:
-  explicit DFA(const Expression& expression);
-  explicit DFA(const NFA& nfa);
+  explicit DFA(const Expression& expression,
+               Expression::Construction construction = Expression::Construction::Thompson);
+  explicit DFA(const NFA& nfa, const DeterminizeOptions& options = {});
 
-  std::vector<std::tuple<size_t, std::string, size_t>> getTransitions() const final;
+  void forEachTransition(TransitionVisitor visitor) const final;
   size_t getSize() const final;
 
   bool checkWord(const std::string& s) const;
 
  private:
+  friend class CDFA;
+  friend class Matcher;
+
+  struct Successor;
+  struct Frontier;
+
+  static constexpr size_t kMinChunk = 64;
+  static constexpr size_t kBlowupFactor = 4;
+
   std::vector<std::map<char, size_t>> m_transitions;
+
+  explicit DFA(Expression::DerivativeTable&& table);
+
+  bool determinize(const SymbolGraph& graph, size_t threads, size_t stateLimit);
+
+  static void collectPatterns(const SymbolGraph& graph, std::span<const uint32_t> states,
+                              std::vector<size_t>& patterns);
+  static void expandFrontier(const SymbolGraph& graph, const StateSetTable& table, size_t begin, size_t end,
+                             Frontier& frontier);
+};
+
+struct DFA::Successor {
+  size_t index;
+  size_t keyBegin;
+  size_t keyEnd;
+  size_t patternBegin;
+  size_t patternEnd;
+  bool final;
+};
+
+struct DFA::Frontier {
+  size_t begin;
+  size_t end;
+  std::vector<Successor> successors;
+  std::vector<uint32_t> keys;
+  std::vector<size_t> patterns;
 };
@@ -0,0 +1,43 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : LazyDFA.hpp
+ ******************************************/
+
+#pragma once
+
+#include <string_view>
+
+#include "StateSet.hpp"
+#include "SymbolGraph.hpp"
+
+class NFA;
+
+class LazyDFA {
+ public:
+  explicit LazyDFA(const NFA& nfa, size_t memoryLimit = size_t(16) << 20);
+
+  bool checkWord(std::string_view word);
+
+  size_t getCachedSize() const;
+  size_t getFlushCount() const;
+
+ private:
+  static constexpr uint32_t kUnknown = std::numeric_limits<uint32_t>::max();
+
+  SymbolGraph m_graph;
+  StateSetTable m_table;
+  std::vector<uint32_t> m_transitions;
+  std::vector<bool> m_final;
+  size_t m_memoryLimit;
+  size_t m_flushCount;
+
+  SparseSet m_move;
+  std::vector<uint32_t> m_members;
+  std::vector<uint32_t> m_key;
+
+  uint32_t addState(std::span<const uint32_t> states);
+  uint32_t computeTransition(uint32_t state, size_t symbol);
+  size_t getMemoryUsage() const;
+  void flush();
+};
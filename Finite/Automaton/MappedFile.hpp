@@ -0,0 +1,29 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : MappedFile.hpp
+ ******************************************/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+class MappedFile {
+ public:
+  enum class Access { Sequential, Preload };
+
+  explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  MappedFile& operator=(const MappedFile& other) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  std::string_view getData() const;
+
+ private:
+  void* m_data;
+  size_t m_size;
+};
@@ -0,0 +1,116 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : Matcher.hpp
+ ******************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "Automaton.hpp"
+
+class DFA;
+class CDFA;
+
+class Matcher {
+ public:
+  enum class Kernel { Scalar, Interleaved, Gather };
+
+  static constexpr size_t kLanes = 16;
+  static constexpr uint32_t kVersion = 2;
+
+  explicit Matcher(const DFA& dfa);
+  explicit Matcher(const CDFA& cdfa);
+
+  static Matcher load(const std::string& path);
+  void save(const std::string& path) const;
+
+  size_t getSize() const;
+  std::string_view getAlphabet() const;
+
+  bool checkWord(std::string_view word) const;
+  std::vector<size_t> matchPatterns(std::string_view word) const;
+  std::vector<bool> checkWords(std::span<const std::string_view> words, Kernel kernel = Kernel::Interleaved) const;
+
+ private:
+  friend class CDFA;
+  friend class Scanner;
+
+  struct Header;
+  struct Image;
+  struct Lanes;
+
+  static constexpr size_t kAlignment = 64;
+
+  std::shared_ptr<const void> m_storage;
+  const Header* m_header;
+  const uint16_t* m_columns;
+  const uint32_t* m_table;
+  const uint64_t* m_final;
+  const uint32_t* m_patternIndex;
+  const uint32_t* m_patterns;
+  size_t m_stride;
+
+  Matcher() = default;
+
+  Image allocate(const Automaton& automaton, size_t stride);
+  void attach(const void* data);
+
+  bool isFinal(uint32_t offset) const;
+
+  bool settle(Lanes& lanes, std::span<const std::string_view> words, std::vector<bool>& res) const;
+  void checkInterleaved(std::span<const std::string_view> words, std::vector<bool>& res) const;
+  void checkGather(std::span<const std::string_view> words, std::vector<bool>& res) const;
+};
+
+struct Matcher::Header {
+  std::array<char, 8> magic;
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t size;
+  uint64_t stride;
+  uint64_t alphabetSize;
+  uint64_t alphabetOffset;
+  uint64_t columnsOffset;
+  uint64_t tableOffset;
+  uint64_t finalOffset;
+  uint64_t patternCount;
+  uint64_t patternIndexOffset;
+  uint64_t patternOffset;
+  uint64_t imageSize;
+
+  Header() = default;
+  Header(size_t size, size_t stride, size_t alphabetSize, size_t patternCount);
+
+  void validate(size_t available) const;
+};
+
+struct Matcher::Image {
+  uint16_t* columns;
+  uint32_t* table;
+  uint64_t* final;
+  uint32_t* patternIndex;
+  uint32_t* patterns;
+
+  void setFinal(size_t offset);
+};
+
+struct Matcher::Lanes {
+  std::array<const unsigned char*, kLanes> position;
+  std::array<size_t, kLanes> increment;
+  std::array<size_t, kLanes> remaining;
+  std::array<size_t, kLanes> word;
+  alignas(32) std::array<uint32_t, kLanes> offset;
+  size_t next;
+
+  Lanes();
+
+  void assign(size_t lane, std::span<const std::string_view> words);
+  size_t getSteps() const;
+  void advance(size_t steps);
+};
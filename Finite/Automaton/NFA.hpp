@@ -1,6 +1,6 @@
 #pragma once
 
-#include <stack>
+#include <limits>
 
 #include "Automaton.hpp"
 
@@ -8,48 +8,92 @@ class Expression;
 
 class NFA : public Automaton {
  public:
+  class Builder;
+
   NFA(size_t n, const std::string& alphabet);
   explicit NFA(const Expression& expression);
 
   void addTransition(const std::tuple<size_t, std::string, size_t>& transition);
+  void addTransition(size_t from, std::string_view label, size_t to);
   void addFinalState(size_t state);
+  void addFinalState(size_t state, size_t pattern);
 
-  std::vector<std::tuple<size_t, std::string, size_t>> getTransitions() const final;
+  void forEachTransition(TransitionVisitor visitor) const final;
   size_t getSize() const final;
 
+  bool hasEpsilon() const;
   NFA throwEpsilon() const;
+  NFA reduce() const;
 
+  // += reuses the start state once it has no incoming edges, so repeated unions cost O(other).
+  // *= retargets every final state of *this and is linear in its size; use NFA::Builder for long products.
   NFA& operator+=(const NFA& other);
   NFA& operator*=(const NFA& other);
 
-  NFA operator+(const NFA& other) const;
-  NFA operator*(const NFA& other) const;
-  NFA operator*() const;
+  NFA operator+(const NFA& other) const&;
+  NFA operator+(const NFA& other) &&;
+  NFA operator*(const NFA& other) const&;
+  NFA operator*(const NFA& other) &&;
+  NFA operator*() const&;
+  NFA operator*() &&;
 
  private:
-  std::vector<std::map<std::string, std::vector<size_t>>> m_transitions;
+  struct Edge;
+
+  static constexpr size_t kNoState = std::numeric_limits<size_t>::max();
 
-  enum class VertexColor;
+  std::vector<Edge> m_edges;
+  std::vector<std::string> m_labels;
+  std::map<std::string, size_t, std::less<>> m_labelIds;
+  bool m_startIsolated = false;
 
-  struct DFSData;
+  size_t addState();
+  size_t getLabelId(std::string_view label);
+  void prependState();
+  void appendShifted(const NFA& other, size_t shift);
+  void mergeAlphabet(const std::string& alphabet);
+
+  struct Graph;
   struct Condensation;
 
-  static void DFS(const std::vector<std::vector<size_t>>& graph, size_t v, DFSData& data);
-  static Condensation condensate(const std::vector<std::vector<size_t>>& graph);
+  static Condensation condensate(const Graph& graph);
+
+  Graph getAdjacency(bool reverse) const;
+  NFA trim() const;
+  NFA mergeBisimilar(bool backward) const;
+  NFA quotient(const std::vector<size_t>& blocks, size_t count) const;
 };
 
-enum class NFA::VertexColor { White, Grey, Black, Purple };
+class NFA::Builder {
+ public:
+  struct Fragment;
 
-struct NFA::DFSData {
-  std::vector<VertexColor> vertexColors;
-  std::vector<size_t> timeIn;
-  std::vector<size_t> upTime;
-  std::vector<size_t> vertexComponents;
-  size_t timer;
-  size_t componentCnt;
-  std::stack<size_t> vertexStack;
+  Fragment unity();
+  Fragment symbol(std::string_view label);
+  Fragment sum(const Fragment& left, const Fragment& right);
+  Fragment product(const Fragment& left, const Fragment& right);
+  Fragment star(const Fragment& fragment);
+
+  NFA build(const Fragment& fragment, const std::string& alphabet) &&;
+
+ private:
+  NFA m_nfa{0, ""};
+};
+
+struct NFA::Builder::Fragment {
+  size_t start;
+  size_t accept;
+};
+
+struct NFA::Edge {
+  size_t from;
+  size_t label;
+  size_t to;
+};
 
-  explicit DFSData(size_t n);
+struct NFA::Graph {
+  std::vector<size_t> begin;
+  std::vector<size_t> targets;
 };
 
 struct NFA::Condensation {
@@ -0,0 +1,35 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : NFASimulator.hpp
+ ******************************************/
+
+#pragma once
+
+#include <string_view>
+
+#include "SymbolGraph.hpp"
+
+class NFA;
+
+class NFASimulator {
+ public:
+  static constexpr size_t kDenseLimit = size_t(64) << 20;
+
+  explicit NFASimulator(const NFA& nfa);
+
+  size_t getSize() const;
+
+  bool checkWord(std::string_view word) const;
+
+ private:
+  SymbolGraph m_graph;
+  size_t m_words;
+  bool m_dense;
+  std::vector<uint64_t> m_masks;
+  std::vector<uint64_t> m_active;
+  std::vector<uint64_t> m_final;
+
+  const uint64_t* getMask(size_t symbol, size_t state) const;
+  void step(const std::vector<uint64_t>& current, size_t symbol, std::vector<uint64_t>& next) const;
+};
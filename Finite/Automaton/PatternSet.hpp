@@ -0,0 +1,26 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : PatternSet.hpp
+ ******************************************/
+
+#pragma once
+
+#include "NFA.hpp"
+
+class Expression;
+
+class PatternSet {
+ public:
+  PatternSet() = default;
+
+  size_t add(const Expression& expression);
+  size_t add(const NFA& nfa);
+
+  size_t getSize() const;
+
+  NFA toNFA() const;
+
+ private:
+  std::vector<NFA> m_patterns;
+};
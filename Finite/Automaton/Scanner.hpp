@@ -0,0 +1,37 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : Scanner.hpp
+ ******************************************/
+
+#pragma once
+
+#include <functional>
+
+#include "Matcher.hpp"
+
+class CDFA;
+class DFA;
+
+class Scanner {
+ public:
+  enum class Mode { Anchored, Search };
+
+  explicit Scanner(const CDFA& cdfa, Mode mode = Mode::Anchored);
+  explicit Scanner(const DFA& dfa, Mode mode = Mode::Anchored);
+
+  void feed(std::string_view chunk, const std::function<void(size_t)>& onMatch = nullptr);
+  void feedFile(const std::string& path, const std::function<void(size_t)>& onMatch = nullptr);
+  void reset();
+
+  bool isAccepting() const;
+  size_t getOffset() const;
+
+ private:
+  Matcher m_matcher;
+  uint32_t m_state;
+  size_t m_offset;
+  bool m_started;
+
+  static CDFA buildSearchAutomaton(const CDFA& cdfa);
+};
@@ -0,0 +1,94 @@
+#include "AntichainChecker.hpp"
+
+#include <algorithm>
+
+#include "NFA.hpp"
+#include "StateSet.hpp"
+
+AntichainChecker::AntichainChecker(const NFA& nfa)
+    : m_graph(nfa.hasEpsilon() ? SymbolGraph(nfa.throwEpsilon()) : SymbolGraph(nfa)), m_alphabet(nfa.getAlphabet()) {}
+
+size_t AntichainChecker::getSize() const { return m_graph.getSize(); }
+
+CDFA::Comparison AntichainChecker::isUniversal() const { return explore(nullptr, m_alphabet); }
+
+CDFA::Comparison AntichainChecker::includes(const NFA& other) const {
+  SymbolGraph graph = other.hasEpsilon() ? SymbolGraph(other.throwEpsilon()) : SymbolGraph(other);
+  std::string alphabet;
+  for (size_t symbol = 0; symbol < graph.getSymbolCount(); ++symbol) {
+    alphabet.push_back(graph.getSymbol(symbol));
+  }
+  return explore(&graph, alphabet);
+}
+
+CDFA::Comparison AntichainChecker::explore(const SymbolGraph* other, const std::string& alphabet) const {
+  if (other && other->getSize() == 0) {
+    return {true, ""};
+  }
+
+  std::vector<Macrostate> macrostates;
+  std::vector<std::vector<size_t>> antichains(other ? other->getSize() : 1);
+  auto add = [&macrostates, &antichains](uint32_t state, std::vector<uint32_t>&& subset, size_t previous, char symb) {
+    auto& antichain = antichains[state];
+    for (size_t index : antichain) {
+      const auto& smaller = macrostates[index].subset;
+      if (std::includes(subset.begin(), subset.end(), smaller.begin(), smaller.end())) {
+        return;
+      }
+    }
+    std::erase_if(antichain, [&macrostates, &subset](size_t index) {
+      auto& larger = macrostates[index];
+      larger.removed = std::includes(larger.subset.begin(), larger.subset.end(), subset.begin(), subset.end());
+      return larger.removed;
+    });
+    antichain.push_back(macrostates.size());
+    macrostates.push_back({state, std::move(subset), previous, symb, false});
+  };
+
+  std::vector<uint32_t> start;
+  if (m_graph.getSize() != 0) {
+    start.push_back(0);
+  }
+  add(0, std::move(start), kNoMacrostate, 0);
+
+  SparseSet next(m_graph.getSize());
+  for (size_t head = 0; head < macrostates.size(); ++head) {
+    if (macrostates[head].removed) {
+      continue;
+    }
+
+    uint32_t state = macrostates[head].state;
+    const auto& subset = macrostates[head].subset;
+    bool accepted = !other || other->isFinal(state);
+    auto isFinal = [this](uint32_t vertex) { return m_graph.isFinal(vertex); };
+    if (accepted && std::none_of(subset.begin(), subset.end(), isFinal)) {
+      std::string counterexample;
+      for (size_t index = head; macrostates[index].previous != kNoMacrostate; index = macrostates[index].previous) {
+        counterexample.push_back(macrostates[index].symbol);
+      }
+      std::reverse(counterexample.begin(), counterexample.end());
+      return {false, counterexample};
+    }
+
+    for (char symb : alphabet) {
+      size_t symbol = m_graph.getSymbolIndex(symb);
+      next.clear();
+      for (size_t index = 0; symbol != SymbolGraph::kNoSymbol && index < macrostates[head].subset.size(); ++index) {
+        for (uint32_t to : m_graph.getTransitions(macrostates[head].subset[index], symbol)) {
+          next.insert(to);
+        }
+      }
+      std::vector<uint32_t> successor(next.values().begin(), next.values().end());
+      std::sort(successor.begin(), successor.end());
+
+      if (!other) {
+        add(0, std::move(successor), head, symb);
+        continue;
+      }
+      for (uint32_t to : other->getTransitions(state, other->getSymbolIndex(symb))) {
+        add(to, std::vector<uint32_t>(successor), head, symb);
+      }
+    }
+  }
+  return {true, ""};
+}
@@ -2,6 +2,12 @@
 
 Automaton::Automaton(size_t size, const std::string& alphabet) : m_final(size), m_alphabet(alphabet) {}
 
+std::vector<std::tuple<size_t, std::string, size_t>> Automaton::getTransitions() const {
+  std::vector<std::tuple<size_t, std::string, size_t>> res;
+  forEachTransition([&res](size_t from, std::string_view label, size_t to) { res.emplace_back(from, label, to); });
+  return res;
+}
+
 std::vector<size_t> Automaton::getFinalStates() const {
   std::vector<size_t> res;
   for (size_t vertex = 0; vertex < m_final.size(); ++vertex) {
@@ -14,6 +20,15 @@ std::vector<size_t> Automaton::getFinalStates() const {
 
 std::string Automaton::getAlphabet() const { return m_alphabet; }
 
+bool Automaton::hasPatterns() const { return !m_patterns.empty(); }
+
+std::vector<size_t> Automaton::getPatterns(size_t vertex) const {
+  if (hasPatterns()) {
+    return m_patterns[vertex];
+  }
+  return m_final[vertex] ? std::vector<size_t>{0} : std::vector<size_t>{};
+}
+
 std::ostream& operator<<(std::ostream& out, const Automaton& automaton) {
   if (automaton.getSize() == 0) {
     return out;
@@ -26,11 +41,11 @@ std::ostream& operator<<(std::ostream& out, const Automaton& automaton) {
   }
 
   out << "\n\nTransitions (format: \"from letter to\"):\n";
-  for (const auto& [from, s, to] : automaton.getTransitions()) {
+  automaton.forEachTransition([&out](size_t from, std::string_view label, size_t to) {
     out << from << ' ';
-    out << (s.empty() ? "-" : s.c_str()) << ' ';
+    out << (label.empty() ? "-" : label) << ' ';
     out << to << '\n';
-  }
+  });
 
   return out;
 }
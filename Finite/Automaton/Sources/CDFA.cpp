@@ -1,20 +1,29 @@
 #include "CDFA.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "DFA.hpp"
+#include "Matcher.hpp"
 
-CDFA::CDFA(const Expression& expression) : CDFA(DFA(expression)) {}
+CDFA::CDFA(const Expression& expression, Expression::Construction construction)
+    : CDFA(DFA(expression, construction)) {}
 
 CDFA::CDFA(const NFA& nfa) : CDFA(DFA(nfa)) {}
 
 CDFA::CDFA(const DFA& dfa) : CDFA(dfa.getSize() + 1, dfa.getAlphabet()) {
+  std::fill(m_transitions.begin(), m_transitions.end(), dfa.getSize());
   for (size_t vertex = 0; vertex < dfa.getSize(); ++vertex) {
-    for (size_t index = 0; index < m_alphabet.size(); ++index) {
-      m_transitions[vertex][index] = dfa.getSize();
-      for (const auto& [from, symb, to] : dfa.getTransitions()) {
-        if (from == vertex && symb[0] == m_alphabet[index]) {
-          m_transitions[vertex][index] = to;
-          break;
-        }
+    for (const auto& [symb, to] : dfa.m_transitions[vertex]) {
+      size_t symbolClass = m_classes[static_cast<unsigned char>(symb)];
+      if (symbolClass != kNoClass) {
+        setTransition(vertex, symbolClass, to);
       }
     }
   }
@@ -22,59 +31,452 @@ CDFA::CDFA(const DFA& dfa) : CDFA(dfa.getSize() + 1, dfa.getAlphabet()) {
   for (size_t vertex : dfa.getFinalStates()) {
     m_final[vertex] = true;
   }
-  for (size_t index = 0; index < m_alphabet.size(); ++index) {
-    m_transitions[dfa.getSize()][index] = dfa.getSize();
+  if (dfa.hasPatterns()) {
+    m_patterns = dfa.m_patterns;
+    m_patterns.resize(getSize());
   }
 
   *this = minimize();
 }
 
-std::vector<std::tuple<size_t, std::string, size_t>> CDFA::getTransitions() const {
-  std::vector<std::tuple<size_t, std::string, size_t>> res;
-  for (size_t vertex = 0; vertex < m_transitions.size(); ++vertex) {
+CDFA CDFA::load(const std::string& path) {
+  Matcher matcher = Matcher::load(path);
+  size_t stride = matcher.m_stride;
+
+  CDFA res(matcher.getSize(), std::string(matcher.getAlphabet()));
+  res.m_classCount = stride - 1;
+  for (size_t symb = 0; symb < res.m_classes.size(); ++symb) {
+    size_t column = matcher.m_columns[symb];
+    if (column >= stride) {
+      throw std::runtime_error("Corrupted compiled automaton: " + path);
+    }
+    res.m_classes[symb] = column == res.m_classCount ? kNoClass : column;
+  }
+
+  res.m_transitions.assign(res.getSize() * res.m_classCount, 0);
+  for (size_t vertex = 0; vertex < res.getSize(); ++vertex) {
+    for (size_t symbolClass = 0; symbolClass < res.m_classCount; ++symbolClass) {
+      size_t offset = matcher.m_table[vertex * stride + symbolClass];
+      if (offset % stride != 0 || offset / stride >= res.getSize()) {
+        throw std::runtime_error("Corrupted compiled automaton: " + path);
+      }
+      res.setTransition(vertex, symbolClass, offset / stride);
+    }
+    res.m_final[vertex] = matcher.isFinal(vertex * stride);
+  }
+
+  size_t patternCount = matcher.m_header->patternCount;
+  if (patternCount != 0) {
+    res.m_patterns.resize(res.getSize());
+    for (size_t vertex = 0; vertex < res.getSize(); ++vertex) {
+      size_t begin = matcher.m_patternIndex[vertex];
+      size_t end = matcher.m_patternIndex[vertex + 1];
+      if (begin > end || end > patternCount || res.m_final[vertex] != (begin != end)) {
+        throw std::runtime_error("Corrupted compiled automaton: " + path);
+      }
+      res.m_patterns[vertex].assign(matcher.m_patterns + begin, matcher.m_patterns + end);
+    }
+  }
+
+  return res.minimize();
+}
+
+void CDFA::save(const std::string& path) const { Matcher(*this).save(path); }
+
+void CDFA::forEachTransition(TransitionVisitor visitor) const {
+  for (size_t vertex = 0; vertex < getSize(); ++vertex) {
     for (size_t index = 0; index < m_alphabet.size(); ++index) {
-      res.emplace_back(vertex, std::string(1, m_alphabet[index]), m_transitions[vertex][index]);
+      size_t symbolClass = m_classes[static_cast<unsigned char>(m_alphabet[index])];
+      visitor(vertex, std::string_view(m_alphabet).substr(index, 1), getTransition(vertex, symbolClass));
     }
   }
-  return res;
 }
 
-size_t CDFA::getSize() const { return m_transitions.size(); }
+size_t CDFA::getSize() const { return m_final.size(); }
+
+size_t CDFA::getClassCount() const { return m_classCount; }
 
 CDFA CDFA::operator~() const {
   CDFA res = *this;
+  res.m_patterns.clear();
   for (size_t index = 0; index < res.m_final.size(); ++index) {
     res.m_final[index] = !res.m_final[index];
   }
   return res;
 }
 
+CDFA CDFA::operator&(const CDFA& other) const { return combine(*this, other, Operation::Intersection); }
+
+CDFA CDFA::operator|(const CDFA& other) const { return combine(*this, other, Operation::Union); }
+
+CDFA CDFA::operator-(const CDFA& other) const { return combine(*this, other, Operation::Difference); }
+
+CDFA CDFA::operator^(const CDFA& other) const { return combine(*this, other, Operation::SymmetricDifference); }
+
+CDFA CDFA::combine(const CDFA& left, const CDFA& right, Operation operation, bool minimized) {
+  std::array<uint16_t, 256> classes;
+  std::vector<Column> columns = pairClasses(left, right, classes);
+  std::string alphabet;
+  for (size_t symb = 0; symb < classes.size(); ++symb) {
+    if (classes[symb] != kNoClass) {
+      alphabet.push_back(static_cast<char>(symb));
+    }
+  }
+
+  CDFA res(0, alphabet);
+  res.m_classes = classes;
+  res.m_classCount = columns.size();
+
+  std::vector<StateKind> leftKinds = left.classifyStates(left.m_alphabet.size() == alphabet.size());
+  std::vector<StateKind> rightKinds = right.classifyStates(right.m_alphabet.size() == alphabet.size());
+  std::vector<std::pair<size_t, size_t>> queue;
+  std::unordered_map<size_t, size_t> index;
+  std::array<size_t, 2> decided{kNoState, kNoState};
+  auto intern = [&](size_t from, size_t to) {
+    StateKind kind = combineKinds(operation, leftKinds[from], rightKinds[to]);
+    if (kind != StateKind::Other) {
+      size_t& state = decided[static_cast<size_t>(kind)];
+      if (state == kNoState) {
+        state = queue.size();
+        queue.emplace_back(kNoState, static_cast<size_t>(kind));
+      }
+      return state;
+    }
+    auto [it, inserted] = index.try_emplace(from * (right.getSize() + 1) + to, queue.size());
+    if (inserted) {
+      queue.emplace_back(from, to);
+    }
+    return it->second;
+  };
+
+  intern(0, 0);
+  for (size_t head = 0; head < queue.size(); ++head) {
+    if (queue.size() * res.m_classCount > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("Automaton is too large");
+    }
+
+    auto [from, to] = queue[head];
+    if (from == kNoState) {
+      res.m_final.push_back(to == static_cast<size_t>(StateKind::Universal));
+      res.m_transitions.insert(res.m_transitions.end(), res.m_classCount, head);
+      continue;
+    }
+
+    bool leftFinal = from < left.getSize() && left.m_final[from];
+    bool rightFinal = to < right.getSize() && right.m_final[to];
+    res.m_final.push_back(combineFinal(operation, leftFinal, rightFinal));
+    for (const Column& column : columns) {
+      res.m_transitions.push_back(intern(left.advance(from, column.left), right.advance(to, column.right)));
+    }
+  }
+
+  return minimized ? res.minimize() : res;
+}
+
+CDFA::Comparison CDFA::equivalent(const CDFA& left, const CDFA& right) {
+  std::array<uint16_t, 256> classes;
+  std::vector<Column> columns = pairClasses(left, right, classes);
+
+  size_t offset = left.getSize() + 1;
+  std::vector<size_t> parent(offset + right.getSize() + 1);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](size_t vertex) {
+    while (parent[vertex] != vertex) {
+      vertex = parent[vertex] = parent[parent[vertex]];
+    }
+    return vertex;
+  };
+
+  std::vector<Step> steps{{0, 0, kNoState, 0}};
+  parent[find(offset)] = find(0);
+  for (size_t head = 0; head < steps.size(); ++head) {
+    auto [from, to, previous, symbol] = steps[head];
+    if ((from < left.getSize() && left.m_final[from]) != (to < right.getSize() && right.m_final[to])) {
+      return {false, buildCounterexample(steps, head)};
+    }
+    for (const Column& column : columns) {
+      size_t leftNext = left.advance(from, column.left);
+      size_t rightNext = right.advance(to, column.right);
+      size_t leftRoot = find(leftNext);
+      size_t rightRoot = find(offset + rightNext);
+      if (leftRoot != rightRoot) {
+        parent[rightRoot] = leftRoot;
+        steps.push_back({leftNext, rightNext, head, column.symbol});
+      }
+    }
+  }
+  return {true, ""};
+}
+
+CDFA::Comparison CDFA::includes(const CDFA& container, const CDFA& contained) {
+  std::array<uint16_t, 256> classes;
+  std::vector<Column> columns = pairClasses(container, contained, classes);
+
+  std::vector<Step> steps{{0, 0, kNoState, 0}};
+  std::unordered_set<size_t> visited{0};
+  for (size_t head = 0; head < steps.size(); ++head) {
+    auto [from, to, previous, symbol] = steps[head];
+    if (to == contained.getSize()) {
+      continue;
+    }
+    if (contained.m_final[to] && !(from < container.getSize() && container.m_final[from])) {
+      return {false, buildCounterexample(steps, head)};
+    }
+    for (const Column& column : columns) {
+      size_t leftNext = container.advance(from, column.left);
+      size_t rightNext = contained.advance(to, column.right);
+      if (visited.insert(leftNext * (contained.getSize() + 1) + rightNext).second) {
+        steps.push_back({leftNext, rightNext, head, column.symbol});
+      }
+    }
+  }
+  return {true, ""};
+}
+
 CDFA CDFA::minimize() const {
+  if (getSize() == 0) {
+    return *this;
+  }
+
   EquivalenceRelation relation = findEquivalentStates();
-  CDFA res(relation.equivalenceClasses.size(), m_alphabet);
+  std::vector<size_t> order(relation.equivalenceClasses.size(), kNoState);
+  std::vector<size_t> queue{relation.classIndex[0]};
+  order[queue[0]] = 0;
+  for (size_t head = 0; head < queue.size(); ++head) {
+    size_t vertex = relation.equivalenceClasses[queue[head]][0];
+    for (size_t symbolClass = 0; symbolClass < m_classCount; ++symbolClass) {
+      size_t to = relation.classIndex[getTransition(vertex, symbolClass)];
+      if (order[to] == kNoState) {
+        order[to] = queue.size();
+        queue.push_back(to);
+      }
+    }
+  }
 
-  for (size_t index = 0; index < relation.equivalenceClasses.size(); ++index) {
-    size_t vertex = relation.equivalenceClasses[index][0];
-    for (size_t j = 0; j < m_alphabet.size(); ++j) {
-      res.m_transitions[index][j] = relation.classIndex[m_transitions[vertex][j]];
+  CDFA res = *this;
+  res.m_final.assign(queue.size(), false);
+  res.m_transitions.assign(queue.size() * m_classCount, 0);
+  if (hasPatterns()) {
+    res.m_patterns.assign(queue.size(), {});
+  }
+  for (size_t index = 0; index < queue.size(); ++index) {
+    size_t vertex = relation.equivalenceClasses[queue[index]][0];
+    for (size_t symbolClass = 0; symbolClass < m_classCount; ++symbolClass) {
+      res.setTransition(index, symbolClass, order[relation.classIndex[getTransition(vertex, symbolClass)]]);
     }
     res.m_final[index] = m_final[vertex];
+    if (hasPatterns()) {
+      res.m_patterns[index] = m_patterns[vertex];
+    }
+  }
+
+  res.compressAlphabet();
+  return res;
+}
+
+CDFA::CDFA(size_t size, const std::string& alphabet) : Automaton(size, alphabet), m_classCount(0) {
+  m_classes.fill(kNoClass);
+  for (unsigned char symb : alphabet) {
+    m_classes[symb] = 0;
+  }
+  for (auto& symbolClass : m_classes) {
+    if (symbolClass != kNoClass) {
+      symbolClass = m_classCount++;
+    }
+  }
+
+  if (size * m_classCount > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Automaton is too large");
+  }
+  m_transitions.resize(size * m_classCount);
+}
+
+size_t CDFA::getTransition(size_t vertex, size_t symbolClass) const {
+  return m_transitions[vertex * m_classCount + symbolClass];
+}
+
+void CDFA::setTransition(size_t vertex, size_t symbolClass, size_t to) {
+  m_transitions[vertex * m_classCount + symbolClass] = to;
+}
+
+size_t CDFA::advance(size_t vertex, uint16_t symbolClass) const {
+  return vertex == getSize() || symbolClass == kNoClass ? getSize() : getTransition(vertex, symbolClass);
+}
+
+void CDFA::compressAlphabet() {
+  std::vector<size_t> symbolClasses(m_classCount);
+  std::vector<std::tuple<size_t, uint32_t, size_t>> keys(m_classCount);
+
+  size_t count = std::min<size_t>(m_classCount, 1);
+  for (size_t vertex = 0; vertex < getSize() && count < m_classCount; ++vertex) {
+    for (size_t index = 0; index < m_classCount; ++index) {
+      keys[index] = {symbolClasses[index], getTransition(vertex, index), index};
+    }
+    std::sort(keys.begin(), keys.end());
+
+    count = 0;
+    for (size_t index = 0; index < m_classCount; ++index) {
+      if (index > 0 && (std::get<0>(keys[index]) != std::get<0>(keys[index - 1]) ||
+                        std::get<1>(keys[index]) != std::get<1>(keys[index - 1]))) {
+        ++count;
+      }
+      symbolClasses[std::get<2>(keys[index])] = count;
+    }
+    ++count;
+  }
+  if (count == m_classCount) {
+    return;
+  }
+
+  std::vector<size_t> renumber(count, kNoClass);
+  for (size_t index = 0, next = 0; index < m_classCount; ++index) {
+    if (renumber[symbolClasses[index]] == kNoClass) {
+      renumber[symbolClasses[index]] = next++;
+    }
+  }
+
+  std::vector<uint32_t> transitions(getSize() * count);
+  for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+    for (size_t index = 0; index < m_classCount; ++index) {
+      transitions[vertex * count + renumber[symbolClasses[index]]] = getTransition(vertex, index);
+    }
+  }
+  for (auto& symbolClass : m_classes) {
+    if (symbolClass != kNoClass) {
+      symbolClass = renumber[symbolClasses[symbolClass]];
+    }
   }
 
+  m_classCount = count;
+  m_transitions = std::move(transitions);
+}
+
+std::vector<CDFA::Column> CDFA::pairClasses(const CDFA& left, const CDFA& right,
+                                            std::array<uint16_t, 256>& classes) {
+  std::map<std::pair<uint16_t, uint16_t>, size_t> columnIds;
+  std::vector<Column> columns;
+  classes.fill(kNoClass);
+  for (size_t symb = 0; symb < classes.size(); ++symb) {
+    std::pair key{left.m_classes[symb], right.m_classes[symb]};
+    if (key.first == kNoClass && key.second == kNoClass) {
+      continue;
+    }
+    auto [it, inserted] = columnIds.emplace(key, columns.size());
+    if (inserted) {
+      columns.push_back({key.first, key.second, static_cast<char>(symb)});
+    }
+    classes[symb] = it->second;
+  }
+  return columns;
+}
+
+std::string CDFA::buildCounterexample(const std::vector<Step>& steps, size_t last) {
+  std::string res;
+  for (size_t step = last; steps[step].previous != kNoState; step = steps[step].previous) {
+    res.push_back(steps[step].symbol);
+  }
+  std::reverse(res.begin(), res.end());
   return res;
 }
 
-CDFA::CDFA(size_t size, const std::string& alphabet)
-    : Automaton(size, alphabet), m_transitions(size, std::vector<size_t>(alphabet.size())) {}
+std::vector<CDFA::StateKind> CDFA::classifyStates(bool complete) const {
+  std::vector<size_t> inverseBegin(getSize() + 1);
+  for (uint32_t to : m_transitions) {
+    ++inverseBegin[to + 1];
+  }
+  for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+    inverseBegin[vertex + 1] += inverseBegin[vertex];
+  }
+  std::vector<size_t> inverse(m_transitions.size());
+  std::vector<size_t> inverseEnd(inverseBegin.begin(), inverseBegin.end() - 1);
+  for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+    for (size_t symbolClass = 0; symbolClass < m_classCount; ++symbolClass) {
+      inverse[inverseEnd[getTransition(vertex, symbolClass)]++] = vertex;
+    }
+  }
+
+  std::vector<StateKind> kinds(getSize() + 1, StateKind::Dead);
+  for (bool final : {true, false}) {
+    std::vector<bool> reached(getSize());
+    std::vector<size_t> queue;
+    for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+      if (m_final[vertex] == final) {
+        reached[vertex] = true;
+        queue.push_back(vertex);
+      }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+      for (size_t edge = inverseBegin[queue[head]]; edge < inverseBegin[queue[head] + 1]; ++edge) {
+        if (!reached[inverse[edge]]) {
+          reached[inverse[edge]] = true;
+          queue.push_back(inverse[edge]);
+        }
+      }
+    }
+
+    for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+      if (final && reached[vertex]) {
+        kinds[vertex] = StateKind::Other;
+      } else if (!final && !reached[vertex] && complete) {
+        kinds[vertex] = StateKind::Universal;
+      }
+    }
+  }
+  return kinds;
+}
+
+CDFA::StateKind CDFA::combineKinds(Operation operation, StateKind left, StateKind right) {
+  auto constant = [](bool universal) { return universal ? StateKind::Universal : StateKind::Dead; };
+  if (left != StateKind::Other && right != StateKind::Other) {
+    return constant(combineFinal(operation, left == StateKind::Universal, right == StateKind::Universal));
+  }
+  switch (operation) {
+    case Operation::Intersection:
+      return left == StateKind::Dead || right == StateKind::Dead ? StateKind::Dead : StateKind::Other;
+    case Operation::Union:
+      return left == StateKind::Universal || right == StateKind::Universal ? StateKind::Universal : StateKind::Other;
+    case Operation::Difference:
+      return left == StateKind::Dead || right == StateKind::Universal ? StateKind::Dead : StateKind::Other;
+    default:
+      return StateKind::Other;
+  }
+}
+
+bool CDFA::combineFinal(Operation operation, bool left, bool right) {
+  switch (operation) {
+    case Operation::Intersection:
+      return left && right;
+    case Operation::Union:
+      return left || right;
+    case Operation::Difference:
+      return left && !right;
+    case Operation::SymmetricDifference:
+      return left != right;
+    default:
+      throw std::invalid_argument("Unknown boolean operation");
+  }
+}
 
 CDFA::EquivalenceRelation CDFA::buildInitialRelation() const {
   EquivalenceRelation relation;
   relation.classIndex.resize(getSize());
-  relation.equivalenceClasses.resize(2);
 
+  std::array<std::optional<size_t>, 2> finalClass;
+  std::map<std::vector<size_t>, size_t> patternClass;
   for (size_t vertex = 0; vertex < getSize(); ++vertex) {
-    relation.classIndex[vertex] = m_final[vertex];
-    relation.equivalenceClasses[relation.classIndex[vertex]].push_back(vertex);
+    size_t index = relation.equivalenceClasses.size();
+    if (hasPatterns() && m_final[vertex]) {
+      index = patternClass.emplace(m_patterns[vertex], index).first->second;
+    } else {
+      index = finalClass[m_final[vertex]].value_or(index);
+      finalClass[m_final[vertex]] = index;
+    }
+
+    if (index == relation.equivalenceClasses.size()) {
+      relation.equivalenceClasses.emplace_back();
+    }
+    relation.classIndex[vertex] = index;
+    relation.equivalenceClasses[index].push_back(vertex);
   }
 
   return relation;
@@ -82,49 +484,137 @@ CDFA::EquivalenceRelation CDFA::buildInitialRelation() const {
 
 CDFA::EquivalenceRelation CDFA::findEquivalentStates() const {
   EquivalenceRelation relation = buildInitialRelation();
-  std::vector<bool> isDistinguishable(getSize());
-
-  for (bool changed = true; changed;) {
-    changed = false;
-    for (auto& states : relation.equivalenceClasses) {
-      for (size_t index = 0; index < m_alphabet.size(); ++index) {
-        size_t destClass = relation.classIndex[m_transitions[states[0]][index]];
-        bool split = false;
-        for (size_t index = 1; index < states.size(); ++index) {
-          size_t curClass = relation.classIndex[m_transitions[states[index]][index]];
-          isDistinguishable[states[index]] = curClass != destClass;
-          if (isDistinguishable[states[index]]) {
-            split = true;
-          }
-        }
-        if (!split) {
-          continue;
-        }
+  Partition partition(relation);
 
-        changed = true;
-        size_t writeIdx = 0;
-        std::vector<size_t> newClass;
-        for (size_t vertex : states) {
-          if (isDistinguishable[vertex]) {
-            newClass.push_back(vertex);
-          } else {
-            states[writeIdx++] = vertex;
-          }
-          isDistinguishable[vertex] = false;
-        }
+  std::vector<size_t> inverseBegin(m_transitions.size() + 1);
+  for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+    for (size_t symbolClass = 0; symbolClass < m_classCount; ++symbolClass) {
+      ++inverseBegin[symbolClass * getSize() + getTransition(vertex, symbolClass) + 1];
+    }
+  }
+  for (size_t index = 1; index < inverseBegin.size(); ++index) {
+    inverseBegin[index] += inverseBegin[index - 1];
+  }
 
-        states.resize(writeIdx);
-        for (size_t vertex : newClass) {
-          relation.classIndex[vertex] = relation.equivalenceClasses.size();
-        }
-        relation.equivalenceClasses.push_back(std::move(newClass));
-        break;
+  std::vector<size_t> inverse(m_transitions.size());
+  std::vector<size_t> inverseEnd(inverseBegin.begin(), inverseBegin.end() - 1);
+  for (size_t vertex = 0; vertex < getSize(); ++vertex) {
+    for (size_t symbolClass = 0; symbolClass < m_classCount; ++symbolClass) {
+      inverse[inverseEnd[symbolClass * getSize() + getTransition(vertex, symbolClass)]++] = vertex;
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> splitters;
+  std::vector<bool> isSplitter;
+  auto addSplitter = [&](size_t block, size_t symbolClass) {
+    isSplitter.resize(partition.blocks.size() * m_classCount);
+    if (!isSplitter[block * m_classCount + symbolClass]) {
+      isSplitter[block * m_classCount + symbolClass] = true;
+      splitters.emplace_back(block, symbolClass);
+    }
+  };
+
+  size_t largest = 0;
+  for (size_t block = 1; block < partition.blocks.size(); ++block) {
+    if (partition.blockSize(block) > partition.blockSize(largest)) {
+      largest = block;
+    }
+  }
+  for (size_t block = 0; block < partition.blocks.size(); ++block) {
+    for (size_t symbolClass = 0; block != largest && symbolClass < m_classCount; ++symbolClass) {
+      addSplitter(block, symbolClass);
+    }
+  }
+
+  std::vector<size_t> predecessors;
+  std::vector<size_t> touched;
+  while (!splitters.empty()) {
+    auto [splitter, symbolClass] = splitters.back();
+    splitters.pop_back();
+    isSplitter[splitter * m_classCount + symbolClass] = false;
+
+    predecessors.clear();
+    for (size_t index = partition.blocks[splitter].begin; index < partition.blocks[splitter].end; ++index) {
+      size_t row = symbolClass * getSize() + partition.elements[index];
+      predecessors.insert(predecessors.end(), inverse.begin() + inverseBegin[row],
+                          inverse.begin() + inverseBegin[row + 1]);
+    }
+
+    touched.clear();
+    for (size_t vertex : predecessors) {
+      size_t block = partition.blockIndex[vertex];
+      if (partition.blocks[block].marked == partition.blocks[block].begin) {
+        touched.push_back(block);
       }
-      if (changed) {
-        break;
+      partition.mark(vertex);
+    }
+
+    for (size_t block : touched) {
+      if (auto created = partition.split(block)) {
+        for (size_t index = 0; index < m_classCount; ++index) {
+          addSplitter(*created, index);
+        }
       }
     }
   }
 
+  relation.equivalenceClasses.assign(partition.blocks.size(), {});
+  for (size_t block = 0; block < partition.blocks.size(); ++block) {
+    relation.equivalenceClasses[block].assign(partition.elements.begin() + partition.blocks[block].begin,
+                                              partition.elements.begin() + partition.blocks[block].end);
+  }
+  relation.classIndex = std::move(partition.blockIndex);
+
   return relation;
 }
+
+CDFA::Partition::Partition(const EquivalenceRelation& relation)
+    : elements(relation.classIndex.size()), location(relation.classIndex.size()), blockIndex(relation.classIndex) {
+  size_t index = 0;
+  for (const auto& states : relation.equivalenceClasses) {
+    blocks.push_back({index, index, index + states.size()});
+    for (size_t vertex : states) {
+      location[vertex] = index;
+      elements[index++] = vertex;
+    }
+  }
+}
+
+size_t CDFA::Partition::blockSize(size_t block) const { return blocks[block].end - blocks[block].begin; }
+
+void CDFA::Partition::mark(size_t vertex) {
+  Block& block = blocks[blockIndex[vertex]];
+  size_t position = location[vertex];
+  if (position < block.marked) {
+    return;
+  }
+
+  std::swap(elements[position], elements[block.marked]);
+  location[elements[position]] = position;
+  location[vertex] = block.marked++;
+}
+
+std::optional<size_t> CDFA::Partition::split(size_t block) {
+  Block& current = blocks[block];
+  size_t marked = current.marked;
+  current.marked = current.begin;
+  if (marked == current.end) {
+    return std::nullopt;
+  }
+
+  Block created{marked, marked, current.end};
+  if (marked - current.begin < current.end - marked) {
+    created = {current.begin, current.begin, marked};
+    current.begin = marked;
+  } else {
+    current.end = marked;
+  }
+  current.marked = current.begin;
+
+  size_t index = blocks.size();
+  for (size_t position = created.begin; position < created.end; ++position) {
+    blockIndex[elements[position]] = index;
+  }
+  blocks.push_back(created);
+  return index;
+}
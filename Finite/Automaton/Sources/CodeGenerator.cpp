@@ -0,0 +1,134 @@
+#include "CodeGenerator.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace {
+
+const char* toLiteral(bool value) { return value ? "true" : "false"; }
+
+}  // namespace
+
+CodeGenerator::CodeGenerator(const CDFA& cdfa)
+    : m_cdfa(cdfa.minimize()), m_sink(m_cdfa.getSize()), m_universal(m_cdfa.getSize()) {
+  bool total = std::find(m_cdfa.m_classes.begin(), m_cdfa.m_classes.end(), CDFA::kNoClass) == m_cdfa.m_classes.end();
+  for (size_t vertex = 0; vertex < m_cdfa.getSize(); ++vertex) {
+    bool closed = true;
+    for (size_t symbolClass = 0; symbolClass < m_cdfa.m_classCount; ++symbolClass) {
+      closed = closed && m_cdfa.getTransition(vertex, symbolClass) == vertex;
+    }
+    m_sink[vertex] = closed && !m_cdfa.m_final[vertex];
+    m_universal[vertex] = closed && total && m_cdfa.m_final[vertex];
+  }
+}
+
+void CodeGenerator::generate(std::ostream& out, const std::string& function) const {
+  out << "// Generated from a minimal CDFA with " << m_cdfa.getSize() << " states. Do not edit.\n\n";
+  out << "#include <cstddef>\n\n";
+  out << "bool " << function << "(const char* data, std::size_t size) {\n";
+
+  if (m_cdfa.getSize() == 0 || m_sink[0] || m_universal[0]) {
+    out << "  static_cast<void>(data);\n";
+    out << "  static_cast<void>(size);\n";
+    out << "  return " << toLiteral(m_cdfa.getSize() != 0 && m_universal[0]) << ";\n}\n";
+    return;
+  }
+
+  out << "  const unsigned char* it = reinterpret_cast<const unsigned char*>(data);\n";
+  out << "  const unsigned char* end = it + size;\n";
+
+  std::vector<bool> targeted(m_cdfa.getSize());
+  for (size_t vertex = 0; vertex < m_cdfa.getSize(); ++vertex) {
+    for (size_t symb = 0; symb < 256; ++symb) {
+      Action action = getAction(vertex, symb);
+      if (action.type == Action::Type::Jump) {
+        targeted[action.to] = true;
+      }
+    }
+  }
+
+  for (size_t vertex = 0; vertex < m_cdfa.getSize(); ++vertex) {
+    if (m_sink[vertex] || m_universal[vertex] || (vertex != 0 && !targeted[vertex])) {
+      continue;
+    }
+    out << '\n';
+    if (targeted[vertex]) {
+      out << "state_" << vertex << ":\n";
+    }
+    generateState(out, vertex);
+  }
+  out << "}\n";
+}
+
+CodeGenerator::Action CodeGenerator::getAction(size_t vertex, unsigned char symb) const {
+  size_t symbolClass = m_cdfa.m_classes[symb];
+  if (symbolClass == CDFA::kNoClass) {
+    return {Action::Type::Reject, 0};
+  }
+
+  size_t to = m_cdfa.getTransition(vertex, symbolClass);
+  if (m_sink[to]) {
+    return {Action::Type::Reject, 0};
+  }
+  if (m_universal[to]) {
+    return {Action::Type::Accept, 0};
+  }
+  if (to == vertex) {
+    return {Action::Type::Loop, 0};
+  }
+  return {Action::Type::Jump, to};
+}
+
+void CodeGenerator::generateState(std::ostream& out, size_t vertex) const {
+  std::map<Action, std::vector<unsigned char>> cases;
+  for (size_t symb = 0; symb < 256; ++symb) {
+    cases[getAction(vertex, symb)].push_back(symb);
+  }
+
+  auto fallback = cases.begin();
+  for (auto iter = cases.begin(); iter != cases.end(); ++iter) {
+    if (iter->second.size() > fallback->second.size()) {
+      fallback = iter;
+    }
+  }
+
+  auto emitAction = [&out](const Action& action) {
+    switch (action.type) {
+      case Action::Type::Reject:
+        out << "        return false;\n";
+        break;
+      case Action::Type::Accept:
+        out << "        return true;\n";
+        break;
+      case Action::Type::Loop:
+        out << "        continue;\n";
+        break;
+      case Action::Type::Jump:
+        out << "        goto state_" << action.to << ";\n";
+        break;
+    }
+  };
+
+  bool loops = cases.contains({Action::Type::Loop, 0});
+  if (loops) {
+    out << "  while (it != end) {\n";
+  } else {
+    out << "  if (it == end) {\n    return " << toLiteral(m_cdfa.m_final[vertex]) << ";\n  }\n  {\n";
+  }
+  out << "    switch (*it++) {\n";
+  for (const auto& [action, symbs] : cases) {
+    if (action == fallback->first) {
+      continue;
+    }
+    for (unsigned char symb : symbs) {
+      out << "      case " << static_cast<int>(symb) << ":\n";
+    }
+    emitAction(action);
+  }
+  out << "      default:\n";
+  emitAction(fallback->first);
+  out << "    }\n  }\n";
+  if (loops) {
+    out << "  return " << toLiteral(m_cdfa.m_final[vertex]) << ";\n";
+  }
+}
@@ -1,86 +1,131 @@
 #include "DFA.hpp"
 
 #include <algorithm>
-#include <queue>
+#include <stdexcept>
+#include <thread>
 
 #include "NFA.hpp"
+#include "StateSet.hpp"
+#include "SymbolGraph.hpp"
 
-DFA::DFA(const Expression& expression) : DFA(NFA(expression)) {}
+DFA::DFA(const Expression& expression, Expression::Construction construction)
+    : DFA(construction == Expression::Construction::Derivatives ? DFA(expression.buildDerivatives())
+                                                                : DFA(expression.toNFA(construction))) {}
 
-DFA::DFA(const NFA& nfa) : Automaton(0, nfa.getAlphabet()) {
-  NFA without_eps = nfa.throwEpsilon();
+DFA::DFA(Expression::DerivativeTable&& table)
+    : Automaton(0, table.alphabet), m_transitions(std::move(table.transitions)) {
+  m_final = std::move(table.final);
+}
+
+DFA::DFA(const NFA& nfa, const DeterminizeOptions& options) : Automaton(0, nfa.getAlphabet()) {
+  using Reduction = DeterminizeOptions::Reduction;
 
-  size_t size = without_eps.getSize();
-  std::vector<std::vector<std::pair<char, size_t>>> transitions;
-  for (const auto& [from, s, to] : without_eps.getTransitions()) {
-    for (size_t index = 0; index < s.length(); ++index) {
-      size_t start = index == 0 ? from : size - 1;
-      size_t end = index + 1 == s.length() ? to : size++;
-      transitions.resize(size);
-      transitions[start].emplace_back(s[index], end);
+  NFA closure(0, nfa.getAlphabet());
+  if (nfa.hasEpsilon()) {
+    closure = nfa.throwEpsilon();
+  }
+  const NFA& source = nfa.hasEpsilon() ? closure : nfa;
+  if (options.reduce != Reduction::Always) {
+    SymbolGraph graph(source);
+    size_t stateLimit = options.stateLimit;
+    if (options.reduce == Reduction::OnBlowup) {
+      size_t blowupLimit = kBlowupFactor * std::max(graph.getSize(), kMinChunk);
+      stateLimit = stateLimit == 0 ? blowupLimit : std::min(stateLimit, blowupLimit);
+    }
+    if (determinize(graph, options.threads, stateLimit)) {
+      return;
     }
+    if (options.reduce == Reduction::Never) {
+      throw std::length_error("Determinization exceeds the state limit");
+    }
+    m_transitions.clear();
+    m_final.clear();
+    m_patterns.clear();
   }
 
-  std::map<std::vector<size_t>, size_t> indexes{{{0}, 0}};
-  std::queue<std::vector<size_t>> queue;
-  queue.emplace(1, 0);
+  if (!determinize(SymbolGraph(source.reduce()), options.threads, options.stateLimit)) {
+    throw std::length_error("Determinization exceeds the state limit");
+  }
+}
 
-  std::vector<std::tuple<size_t, char, size_t>> newTransitions;
-  while (!queue.empty()) {
-    std::map<char, std::vector<size_t>> currentTransitions;
-    for (const auto& from : queue.front()) {
-      for (auto [symb, to] : transitions[from]) {
-        currentTransitions[symb].push_back(to);
-      }
+bool DFA::determinize(const SymbolGraph& graph, size_t threads, size_t stateLimit) {
+  if (graph.getSize() == 0) {
+    m_transitions.resize(1);
+    m_final.resize(1);
+    return true;
+  }
+
+  StateSetTable table(graph.getSize());
+  std::vector<uint32_t> key;
+  std::vector<uint32_t> start{0};
+  table.encode(start, key);
+  table.intern(key);
+  m_final.push_back(graph.isFinal(0));
+  if (graph.hasPatterns()) {
+    m_patterns.emplace_back(graph.getPatterns(0).begin(), graph.getPatterns(0).end());
+  }
+
+  std::vector<Frontier> chunks;
+  for (size_t begin = 0; begin < table.size();) {
+    size_t end = table.size();
+    size_t chunkCount = std::clamp<size_t>((end - begin) / kMinChunk, 1, std::max<size_t>(threads, 1));
+    size_t chunkSize = (end - begin + chunkCount - 1) / chunkCount;
+
+    chunks.resize(chunkCount);
+    for (size_t index = 0; index < chunkCount; ++index) {
+      chunks[index].begin = std::min(end, begin + index * chunkSize);
+      chunks[index].end = std::min(end, chunks[index].begin + chunkSize);
     }
-    size_t v = indexes[queue.front()];
-    queue.pop();
-    for (auto& [symb, dest] : currentTransitions) {
-      std::sort(dest.begin(), dest.end());
-      dest.resize(std::unique(dest.begin(), dest.end()) - dest.begin());
-      auto it = indexes.find(dest);
-      if (it == indexes.end()) {
-        newTransitions.emplace_back(v, symb, indexes.size());
-        indexes.emplace(dest, indexes.size());
-        queue.push(dest);
-      } else {
-        newTransitions.emplace_back(v, symb, it->second);
+    if (chunkCount == 1) {
+      expandFrontier(graph, table, begin, end, chunks[0]);
+    } else {
+      std::vector<std::jthread> workers;
+      for (auto& chunk : chunks) {
+        workers.emplace_back([&graph, &table, &chunk] { expandFrontier(graph, table, chunk.begin, chunk.end, chunk); });
       }
     }
-  }
 
-  m_transitions.resize(indexes.size());
-  m_final.resize(indexes.size());
-  for (auto [from, symb, to] : newTransitions) {
-    m_transitions[from][symb] = to;
-  }
+    m_transitions.resize(end);
+    for (const auto& chunk : chunks) {
+      const Successor* successor = chunk.successors.data();
+      for (size_t current = chunk.begin; current < chunk.end; ++current) {
+        for (size_t symbol = 0; symbol < graph.getSymbolCount(); ++symbol, ++successor) {
+          if (successor->keyBegin == successor->keyEnd && successor->index == StateSetTable::kNotFound) {
+            continue;
+          }
 
-  std::vector<bool> isFinal(transitions.size());
-  for (const auto& v : without_eps.getFinalStates()) {
-    isFinal[v] = true;
-  }
-  for (const auto& [vertices, index] : indexes) {
-    bool final = false;
-    for (const auto& v : vertices) {
-      if (isFinal[v]) {
-        final = true;
-        break;
+          size_t index = successor->index;
+          if (index == StateSetTable::kNotFound) {
+            bool inserted;
+            std::tie(index, inserted) = table.intern(
+                std::span(chunk.keys.data() + successor->keyBegin, chunk.keys.data() + successor->keyEnd));
+            if (inserted) {
+              m_final.push_back(successor->final);
+              if (graph.hasPatterns()) {
+                m_patterns.emplace_back(chunk.patterns.begin() + successor->patternBegin,
+                                        chunk.patterns.begin() + successor->patternEnd);
+              }
+            }
+          }
+          m_transitions[current].emplace_hint(m_transitions[current].end(), graph.getSymbol(symbol), index);
+        }
       }
     }
-    if (final) {
-      m_final[index] = true;
+    if (stateLimit != 0 && table.size() > stateLimit) {
+      return false;
     }
+    begin = end;
   }
+  m_transitions.resize(table.size());
+  return true;
 }
 
-std::vector<std::tuple<size_t, std::string, size_t>> DFA::getTransitions() const {
-  std::vector<std::tuple<size_t, std::string, size_t>> res;
+void DFA::forEachTransition(TransitionVisitor visitor) const {
   for (size_t from = 0; from < m_transitions.size(); ++from) {
     for (const auto& [symb, to] : m_transitions[from]) {
-      res.emplace_back(from, std::string(1, symb), to);
+      visitor(from, std::string_view(&symb, 1), to);
     }
   }
-  return res;
 }
 
 size_t DFA::getSize() const { return m_transitions.size(); }
@@ -96,3 +141,57 @@ bool DFA::checkWord(const std::string& s) const {
   }
   return m_final[st];
 }
+
+void DFA::collectPatterns(const SymbolGraph& graph, std::span<const uint32_t> states,
+                          std::vector<size_t>& patterns) {
+  size_t begin = patterns.size();
+  for (uint32_t state : states) {
+    auto ids = graph.getPatterns(state);
+    patterns.insert(patterns.end(), ids.begin(), ids.end());
+  }
+  std::sort(patterns.begin() + begin, patterns.end());
+  patterns.erase(std::unique(patterns.begin() + begin, patterns.end()), patterns.end());
+}
+
+void DFA::expandFrontier(const SymbolGraph& graph, const StateSetTable& table, size_t begin, size_t end,
+                         Frontier& frontier) {
+  SparseSet move(graph.getSize());
+  std::vector<uint32_t> members;
+  std::vector<uint32_t> key;
+
+  frontier.successors.clear();
+  frontier.keys.clear();
+  frontier.patterns.clear();
+  for (size_t current = begin; current < end; ++current) {
+    table.decode(current, members);
+    for (size_t symbol = 0; symbol < graph.getSymbolCount(); ++symbol) {
+      move.clear();
+      bool final = false;
+      for (uint32_t from : members) {
+        for (uint32_t to : graph.getTransitions(from, symbol)) {
+          if (move.insert(to)) {
+            final = final || graph.isFinal(to);
+          }
+        }
+      }
+
+      Successor& successor = frontier.successors.emplace_back(StateSetTable::kNotFound, frontier.keys.size(),
+                                                              frontier.keys.size(), frontier.patterns.size(),
+                                                              frontier.patterns.size(), final);
+      if (move.empty()) {
+        continue;
+      }
+
+      table.encode(move.values(), key);
+      successor.index = table.find(key);
+      if (successor.index == StateSetTable::kNotFound) {
+        frontier.keys.insert(frontier.keys.end(), key.begin(), key.end());
+        successor.keyEnd = frontier.keys.size();
+        if (final && graph.hasPatterns()) {
+          collectPatterns(graph, move.values(), frontier.patterns);
+          successor.patternEnd = frontier.patterns.size();
+        }
+      }
+    }
+  }
+}
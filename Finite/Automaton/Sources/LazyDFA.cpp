@@ -0,0 +1,78 @@
+#include "LazyDFA.hpp"
+
+#include "NFA.hpp"
+
+LazyDFA::LazyDFA(const NFA& nfa, size_t memoryLimit)
+    : m_graph(nfa.hasEpsilon() ? SymbolGraph(nfa.throwEpsilon()) : SymbolGraph(nfa)),
+      m_table(m_graph.getSize()),
+      m_memoryLimit(memoryLimit),
+      m_flushCount(0),
+      m_move(m_graph.getSize()) {
+  flush();
+  m_flushCount = 0;
+}
+
+bool LazyDFA::checkWord(std::string_view word) {
+  uint32_t state = 0;
+  for (char symb : word) {
+    size_t symbol = m_graph.getSymbolIndex(symb);
+    if (symbol == SymbolGraph::kNoSymbol) {
+      return false;
+    }
+
+    uint32_t next = m_transitions[state * m_graph.getSymbolCount() + symbol];
+    state = next == kUnknown ? computeTransition(state, symbol) : next;
+  }
+  return m_final[state];
+}
+
+size_t LazyDFA::getCachedSize() const { return m_table.size(); }
+
+size_t LazyDFA::getFlushCount() const { return m_flushCount; }
+
+uint32_t LazyDFA::addState(std::span<const uint32_t> states) {
+  m_table.encode(states, m_key);
+  auto [index, inserted] = m_table.intern(m_key);
+  if (inserted) {
+    bool final = false;
+    for (uint32_t state : states) {
+      final = final || m_graph.isFinal(state);
+    }
+    m_final.push_back(final);
+    m_transitions.resize(m_transitions.size() + m_graph.getSymbolCount(), kUnknown);
+  }
+  return index;
+}
+
+uint32_t LazyDFA::computeTransition(uint32_t state, size_t symbol) {
+  m_table.decode(state, m_members);
+  m_move.clear();
+  for (uint32_t from : m_members) {
+    for (uint32_t to : m_graph.getTransitions(from, symbol)) {
+      m_move.insert(to);
+    }
+  }
+
+  if (getMemoryUsage() > m_memoryLimit) {
+    flush();
+    return addState(m_move.values());
+  }
+
+  uint32_t next = addState(m_move.values());
+  m_transitions[state * m_graph.getSymbolCount() + symbol] = next;
+  return next;
+}
+
+size_t LazyDFA::getMemoryUsage() const {
+  return m_table.getMemoryUsage() + m_transitions.size() * sizeof(uint32_t) + m_final.size() / 8;
+}
+
+void LazyDFA::flush() {
+  ++m_flushCount;
+  m_table.clear();
+  m_transitions.clear();
+  m_final.clear();
+
+  uint32_t start = 0;
+  addState(std::span<const uint32_t>(&start, m_graph.getSize() == 0 ? 0 : 1));
+}
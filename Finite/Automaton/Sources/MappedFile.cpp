@@ -0,0 +1,51 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <utility>
+
+MappedFile::MappedFile(const std::string& path, Access access) : m_data(nullptr), m_size(0) {
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor == -1) {
+    throw std::runtime_error("Cannot open file " + path);
+  }
+
+  struct stat info;
+  if (fstat(descriptor, &info) == -1) {
+    close(descriptor);
+    throw std::runtime_error("Cannot stat file " + path);
+  }
+
+  m_size = info.st_size;
+  if (m_size > 0) {
+    m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  }
+  close(descriptor);
+  if (m_data == MAP_FAILED) {
+    throw std::runtime_error("Cannot map file " + path);
+  }
+  if (m_size > 0) {
+    madvise(m_data, m_size, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+  }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile::~MappedFile() {
+  if (m_data != nullptr) {
+    munmap(m_data, m_size);
+  }
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  std::swap(m_data, other.m_data);
+  std::swap(m_size, other.m_size);
+  return *this;
+}
+
+std::string_view MappedFile::getData() const { return {static_cast<const char*>(m_data), m_size}; }
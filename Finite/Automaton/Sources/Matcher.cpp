@@ -0,0 +1,352 @@
+#include "Matcher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "CDFA.hpp"
+#include "DFA.hpp"
+#include "MappedFile.hpp"
+
+namespace {
+
+constexpr std::array<char, 8> kMagic = {'F', 'A', 'C', 'D', 'F', 'A', '\r', '\n'};
+constexpr uint32_t kByteOrder = 0x01020304;
+
+size_t align(size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+Matcher::Matcher(const DFA& dfa) {
+  std::array<bool, 256> present{};
+  for (unsigned char symb : dfa.getAlphabet()) {
+    present[symb] = true;
+  }
+  for (const auto& transitions : dfa.m_transitions) {
+    for (const auto& [symb, to] : transitions) {
+      present[static_cast<unsigned char>(symb)] = true;
+    }
+  }
+
+  std::array<uint16_t, 256> columns;
+  size_t stride = 0;
+  for (size_t symb = 0; symb < present.size(); ++symb) {
+    if (present[symb]) {
+      columns[symb] = stride++;
+    }
+  }
+  for (size_t symb = 0; symb < present.size(); ++symb) {
+    if (!present[symb]) {
+      columns[symb] = stride;
+    }
+  }
+
+  Image image = allocate(dfa, stride + 1);
+  std::copy(columns.begin(), columns.end(), image.columns);
+  for (size_t from = 0; from < dfa.m_transitions.size(); ++from) {
+    for (const auto& [symb, to] : dfa.m_transitions[from]) {
+      image.table[from * m_stride + columns[static_cast<unsigned char>(symb)]] = to * m_stride;
+    }
+  }
+}
+
+Matcher::Matcher(const CDFA& cdfa) {
+  Image image = allocate(cdfa, cdfa.m_classCount + 1);
+  for (size_t symb = 0; symb < cdfa.m_classes.size(); ++symb) {
+    size_t symbolClass = cdfa.m_classes[symb];
+    image.columns[symb] = symbolClass == CDFA::kNoClass ? cdfa.m_classCount : symbolClass;
+  }
+  for (size_t from = 0; from < cdfa.getSize(); ++from) {
+    for (size_t symbolClass = 0; symbolClass < cdfa.m_classCount; ++symbolClass) {
+      image.table[from * m_stride + symbolClass] = cdfa.getTransition(from, symbolClass) * m_stride;
+    }
+  }
+}
+
+Matcher Matcher::load(const std::string& path) {
+  auto file = std::make_shared<const MappedFile>(path, MappedFile::Access::Preload);
+  std::string_view data = file->getData();
+
+  Header header;
+  if (data.size() < sizeof(Header)) {
+    throw std::runtime_error("Not a compiled automaton: " + path);
+  }
+  std::memcpy(&header, data.data(), sizeof(Header));
+  header.validate(data.size());
+
+  Matcher res;
+  res.m_storage = file;
+  res.attach(data.data());
+  for (size_t symb = 0; symb < 256; ++symb) {
+    if (res.m_columns[symb] >= res.m_stride) {
+      throw std::runtime_error("Corrupted compiled automaton: " + path);
+    }
+  }
+  for (size_t offset = 0; offset < header.size * header.stride; ++offset) {
+    if (res.m_table[offset] % res.m_stride != 0 || res.m_table[offset] / res.m_stride >= header.size) {
+      throw std::runtime_error("Corrupted compiled automaton: " + path);
+    }
+  }
+  return res;
+}
+
+void Matcher::save(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(m_header), m_header->imageSize);
+  if (!out.flush()) {
+    throw std::runtime_error("Cannot write file " + path);
+  }
+}
+
+size_t Matcher::getSize() const { return m_header->size; }
+
+std::string_view Matcher::getAlphabet() const {
+  return {reinterpret_cast<const char*>(m_header) + m_header->alphabetOffset, m_header->alphabetSize};
+}
+
+bool Matcher::checkWord(std::string_view word) const {
+  uint32_t offset = 0;
+  for (unsigned char symb : word) {
+    offset = m_table[offset + m_columns[symb]];
+  }
+  return isFinal(offset);
+}
+
+std::vector<size_t> Matcher::matchPatterns(std::string_view word) const {
+  uint32_t offset = 0;
+  for (unsigned char symb : word) {
+    offset = m_table[offset + m_columns[symb]];
+  }
+  if (!isFinal(offset)) {
+    return {};
+  }
+  if (m_header->patternCount == 0) {
+    return {0};
+  }
+
+  size_t row = offset / m_stride;
+  if (m_patternIndex[row] > m_patternIndex[row + 1] || m_patternIndex[row + 1] > m_header->patternCount) {
+    throw std::runtime_error("Corrupted compiled automaton patterns");
+  }
+  return {m_patterns + m_patternIndex[row], m_patterns + m_patternIndex[row + 1]};
+}
+
+std::vector<bool> Matcher::checkWords(std::span<const std::string_view> words, Kernel kernel) const {
+  std::vector<bool> res(words.size());
+  if (kernel == Kernel::Scalar) {
+    for (size_t index = 0; index < words.size(); ++index) {
+      res[index] = checkWord(words[index]);
+    }
+    return res;
+  }
+
+#if defined(__x86_64__)
+  if (kernel == Kernel::Gather && m_header->size * m_stride <= std::numeric_limits<int32_t>::max() &&
+      __builtin_cpu_supports("avx2")) {
+    checkGather(words, res);
+    return res;
+  }
+#endif
+
+  checkInterleaved(words, res);
+  return res;
+}
+
+Matcher::Image Matcher::allocate(const Automaton& automaton, size_t stride) {
+  size_t size = automaton.getSize();
+  if ((size + 1) * stride > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Automaton is too large to compile");
+  }
+
+  size_t patternCount = 0;
+  for (size_t vertex = 0; automaton.hasPatterns() && vertex < size; ++vertex) {
+    patternCount += automaton.getPatterns(vertex).size();
+  }
+  if (patternCount > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Automaton is too large to compile");
+  }
+
+  std::string alphabet = automaton.getAlphabet();
+  Header header(size + 1, stride, alphabet.size(), patternCount);
+  auto storage = std::make_shared<std::vector<uint64_t>>(header.imageSize / sizeof(uint64_t));
+  auto* data = reinterpret_cast<char*>(storage->data());
+  std::memcpy(data, &header, sizeof(Header));
+  std::copy(alphabet.begin(), alphabet.end(), data + header.alphabetOffset);
+
+  Image image{reinterpret_cast<uint16_t*>(data + header.columnsOffset),
+              reinterpret_cast<uint32_t*>(data + header.tableOffset),
+              reinterpret_cast<uint64_t*>(data + header.finalOffset),
+              reinterpret_cast<uint32_t*>(data + header.patternIndexOffset),
+              reinterpret_cast<uint32_t*>(data + header.patternOffset)};
+  std::fill_n(image.table, header.size * stride, size * stride);
+  for (size_t vertex : automaton.getFinalStates()) {
+    image.setFinal(vertex * stride);
+  }
+  if (patternCount != 0) {
+    for (size_t vertex = 0; vertex < size; ++vertex) {
+      auto patterns = automaton.getPatterns(vertex);
+      image.patternIndex[vertex + 1] = image.patternIndex[vertex] + patterns.size();
+      std::copy(patterns.begin(), patterns.end(), image.patterns + image.patternIndex[vertex]);
+    }
+    image.patternIndex[size + 1] = image.patternIndex[size];
+  }
+
+  m_storage = std::move(storage);
+  attach(data);
+  return image;
+}
+
+void Matcher::attach(const void* data) {
+  const auto* base = static_cast<const char*>(data);
+  m_header = reinterpret_cast<const Header*>(base);
+  m_columns = reinterpret_cast<const uint16_t*>(base + m_header->columnsOffset);
+  m_table = reinterpret_cast<const uint32_t*>(base + m_header->tableOffset);
+  m_final = reinterpret_cast<const uint64_t*>(base + m_header->finalOffset);
+  m_patternIndex = reinterpret_cast<const uint32_t*>(base + m_header->patternIndexOffset);
+  m_patterns = reinterpret_cast<const uint32_t*>(base + m_header->patternOffset);
+  m_stride = m_header->stride;
+}
+
+bool Matcher::isFinal(uint32_t offset) const { return (m_final[offset / 64] >> (offset % 64) & 1) != 0; }
+
+bool Matcher::settle(Lanes& lanes, std::span<const std::string_view> words, std::vector<bool>& res) const {
+  bool active = false;
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    while (lanes.remaining[lane] == 0) {
+      res[lanes.word[lane]] = isFinal(lanes.offset[lane]);
+      lanes.assign(lane, words);
+    }
+    active = active || lanes.increment[lane] != 0;
+  }
+  return active;
+}
+
+void Matcher::checkInterleaved(std::span<const std::string_view> words, std::vector<bool>& res) const {
+  Lanes lanes;
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    lanes.assign(lane, words);
+  }
+
+  while (settle(lanes, words, res)) {
+    size_t steps = lanes.getSteps();
+    for (size_t step = 0; step < steps; ++step) {
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        lanes.offset[lane] = m_table[lanes.offset[lane] + m_columns[*lanes.position[lane]]];
+        lanes.position[lane] += lanes.increment[lane];
+      }
+    }
+    lanes.advance(steps);
+  }
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) void Matcher::checkGather(std::span<const std::string_view> words,
+                                                          std::vector<bool>& res) const {
+  Lanes lanes;
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    lanes.assign(lane, words);
+  }
+
+  const int* table = reinterpret_cast<const int*>(m_table);
+  alignas(32) std::array<uint32_t, kLanes> columns;
+  while (settle(lanes, words, res)) {
+    __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.offset.data()));
+    __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.offset.data() + 8));
+
+    size_t steps = lanes.getSteps();
+    for (size_t step = 0; step < steps; ++step) {
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        columns[lane] = m_columns[*lanes.position[lane]];
+        lanes.position[lane] += lanes.increment[lane];
+      }
+      low = _mm256_add_epi32(low, _mm256_load_si256(reinterpret_cast<const __m256i*>(columns.data())));
+      high = _mm256_add_epi32(high, _mm256_load_si256(reinterpret_cast<const __m256i*>(columns.data() + 8)));
+      low = _mm256_i32gather_epi32(table, low, sizeof(uint32_t));
+      high = _mm256_i32gather_epi32(table, high, sizeof(uint32_t));
+    }
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.offset.data()), low);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.offset.data() + 8), high);
+    lanes.advance(steps);
+  }
+}
+#else
+void Matcher::checkGather(std::span<const std::string_view> words, std::vector<bool>& res) const {
+  checkInterleaved(words, res);
+}
+#endif
+
+Matcher::Header::Header(size_t size, size_t stride, size_t alphabetSize, size_t patternCount)
+    : magic(kMagic),
+      version(kVersion),
+      byteOrder(kByteOrder),
+      size(size),
+      stride(stride),
+      alphabetSize(alphabetSize),
+      patternCount(patternCount) {
+  alphabetOffset = align(sizeof(Header), kAlignment);
+  columnsOffset = align(alphabetOffset + alphabetSize, kAlignment);
+  tableOffset = align(columnsOffset + 256 * sizeof(uint16_t), kAlignment);
+  finalOffset = align(tableOffset + size * stride * sizeof(uint32_t), kAlignment);
+  patternIndexOffset = align(finalOffset + (size * stride + 63) / 64 * sizeof(uint64_t), kAlignment);
+  patternOffset = align(patternIndexOffset + (patternCount == 0 ? 0 : size + 1) * sizeof(uint32_t), kAlignment);
+  imageSize = align(patternOffset + patternCount * sizeof(uint32_t), kAlignment);
+}
+
+void Matcher::Header::validate(size_t available) const {
+  if (magic != kMagic) {
+    throw std::runtime_error("Not a compiled automaton");
+  }
+  if (version != kVersion || byteOrder != kByteOrder) {
+    throw std::runtime_error("Unsupported compiled automaton version or byte order");
+  }
+  if (size == 0 || stride == 0 || stride > 257 || size * stride > std::numeric_limits<uint32_t>::max() ||
+      alphabetSize > 256 || patternCount > available) {
+    throw std::runtime_error("Corrupted compiled automaton header");
+  }
+
+  Header expected(size, stride, alphabetSize, patternCount);
+  if (alphabetOffset != expected.alphabetOffset || columnsOffset != expected.columnsOffset ||
+      tableOffset != expected.tableOffset || finalOffset != expected.finalOffset ||
+      patternIndexOffset != expected.patternIndexOffset || patternOffset != expected.patternOffset ||
+      imageSize != expected.imageSize || imageSize > available) {
+    throw std::runtime_error("Corrupted compiled automaton header");
+  }
+}
+
+void Matcher::Image::setFinal(size_t offset) { final[offset / 64] |= uint64_t{1} << (offset % 64); }
+
+Matcher::Lanes::Lanes() : next(0) {}
+
+void Matcher::Lanes::assign(size_t lane, std::span<const std::string_view> words) {
+  static constexpr unsigned char kIdle = 0;
+
+  offset[lane] = 0;
+  if (next == words.size()) {
+    position[lane] = &kIdle;
+    increment[lane] = 0;
+    remaining[lane] = std::numeric_limits<size_t>::max();
+    return;
+  }
+
+  word[lane] = next;
+  position[lane] = reinterpret_cast<const unsigned char*>(words[next].data());
+  increment[lane] = 1;
+  remaining[lane] = words[next++].size();
+}
+
+size_t Matcher::Lanes::getSteps() const { return *std::min_element(remaining.begin(), remaining.end()); }
+
+void Matcher::Lanes::advance(size_t steps) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    if (increment[lane] != 0) {
+      remaining[lane] -= steps;
+    }
+  }
+}
@@ -1,200 +1,647 @@
 #include "NFA.hpp"
 
 #include <algorithm>
-#include <set>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
 
 #include "Expression.hpp"
 
-NFA::NFA(size_t size, const std::string& alphabet) : Automaton(size, alphabet), m_transitions(size) {}
+NFA::NFA(size_t size, const std::string& alphabet) : Automaton(size, alphabet) {}
 
 NFA::NFA(const Expression& expression) : NFA(expression.toNFA()) {}
 
 void NFA::addTransition(const std::tuple<size_t, std::string, size_t>& transition) {
-  m_transitions[std::get<0>(transition)][std::get<1>(transition)].push_back(std::get<2>(transition));
+  addTransition(std::get<0>(transition), std::get<1>(transition), std::get<2>(transition));
 }
 
-void NFA::addFinalState(size_t state) { m_final[state] = true; }
+void NFA::addTransition(size_t from, std::string_view label, size_t to) {
+  m_edges.push_back({from, getLabelId(label), to});
+  if (to == 0) {
+    m_startIsolated = false;
+  }
+}
 
-std::vector<std::tuple<size_t, std::string, size_t>> NFA::getTransitions() const {
-  std::vector<std::tuple<size_t, std::string, size_t>> res;
+void NFA::addFinalState(size_t state) {
+  if (hasPatterns()) {
+    addFinalState(state, 0);
+    return;
+  }
+  m_final[state] = true;
+}
 
-  for (size_t from = 0; from < m_transitions.size(); ++from) {
-    for (const auto& [s, destinations] : m_transitions[from]) {
-      for (auto to : destinations) {
-        res.emplace_back(from, s, to);
-      }
+void NFA::addFinalState(size_t state, size_t pattern) {
+  if (!hasPatterns()) {
+    m_patterns.resize(getSize());
+    for (size_t vertex : getFinalStates()) {
+      m_patterns[vertex].push_back(0);
     }
   }
 
-  return res;
+  auto& patterns = m_patterns[state];
+  auto it = std::lower_bound(patterns.begin(), patterns.end(), pattern);
+  if (it == patterns.end() || *it != pattern) {
+    patterns.insert(it, pattern);
+  }
+  m_final[state] = true;
+}
+
+void NFA::forEachTransition(TransitionVisitor visitor) const {
+  for (const auto& [from, label, to] : m_edges) {
+    visitor(from, m_labels[label], to);
+  }
 }
 
-size_t NFA::getSize() const { return m_transitions.size(); }
+size_t NFA::getSize() const { return m_final.size(); }
+
+bool NFA::hasEpsilon() const {
+  return std::any_of(m_edges.begin(), m_edges.end(), [this](const Edge& edge) { return m_labels[edge.label].empty(); });
+}
 
 NFA NFA::throwEpsilon() const {
-  std::vector<std::vector<size_t>> epsilonGraph(m_transitions.size());
-  std::vector<std::vector<std::pair<std::string, size_t>>> newTransitions(m_transitions.size());
-  for (const auto& [from, s, to] : getTransitions()) {
-    if (s.empty()) {
-      epsilonGraph[from].push_back(to);
+  size_t size = getSize();
+  if (size > std::numeric_limits<uint32_t>::max() || m_labels.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Automaton is too large");
+  }
+
+  std::vector<size_t> order(m_labels.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) { return m_labels[lhs] < m_labels[rhs]; });
+  std::vector<size_t> rank(m_labels.size());
+  for (size_t index = 0; index < order.size(); ++index) {
+    rank[order[index]] = index;
+  }
+
+  Graph epsilon{std::vector<size_t>(size + 1), {}};
+  Graph symbol{std::vector<size_t>(size + 1), {}};
+  for (const auto& [from, label, to] : m_edges) {
+    ++(m_labels[label].empty() ? epsilon : symbol).begin[from + 1];
+  }
+  for (Graph* graph : {&epsilon, &symbol}) {
+    for (size_t vertex = 0; vertex < size; ++vertex) {
+      graph->begin[vertex + 1] += graph->begin[vertex];
+    }
+    graph->targets.resize(graph->begin[size]);
+  }
+  std::vector<size_t> epsilonNext(epsilon.begin.begin(), epsilon.begin.end() - 1);
+  std::vector<size_t> symbolNext(symbol.begin.begin(), symbol.begin.end() - 1);
+  for (const auto& [from, label, to] : m_edges) {
+    if (m_labels[label].empty()) {
+      epsilon.targets[epsilonNext[from]++] = to;
     } else {
-      newTransitions[from].emplace_back(s, to);
+      symbol.targets[symbolNext[from]++] = rank[label] << 32 | to;
     }
   }
 
-  auto [num_components, components] = condensate(epsilonGraph);
+  auto [num_components, components] = condensate(epsilon);
+  Graph members{std::vector<size_t>(num_components + 1), std::vector<size_t>(size)};
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    ++members.begin[components[vertex] + 1];
+  }
+  for (size_t index = 0; index < num_components; ++index) {
+    members.begin[index + 1] += members.begin[index];
+  }
+  std::vector<size_t> memberNext(members.begin.begin(), members.begin.end() - 1);
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    members.targets[memberNext[components[vertex]]++] = vertex;
+  }
+
   std::vector<bool> hasFinal(num_components);
+  std::vector<std::vector<size_t>> componentPatterns(hasPatterns() ? num_components : 0);
   for (size_t vertex : getFinalStates()) {
     hasFinal[components[vertex]] = true;
+    if (hasPatterns()) {
+      auto& patterns = componentPatterns[components[vertex]];
+      patterns.insert(patterns.end(), m_patterns[vertex].begin(), m_patterns[vertex].end());
+    }
   }
 
-  std::vector<std::vector<size_t>> componentVertices(m_transitions.size());
-  for (size_t vertex = 0; vertex < m_transitions.size(); ++vertex) {
-    componentVertices[components[vertex]].push_back(vertex);
-  }
-
-  std::vector<std::set<std::pair<std::string, size_t>>> componentTransitions(num_components);
+  std::vector<size_t> keyBegin(num_components + 1);
+  std::vector<size_t> keys;
   for (size_t index = 0; index < num_components; ++index) {
-    for (size_t vertex : componentVertices[index]) {
-      componentTransitions[index].insert(newTransitions[vertex].begin(), newTransitions[vertex].end());
-      for (const auto& to : epsilonGraph[vertex]) {
-        if (components[to] == index) {
+    for (size_t member = members.begin[index]; member < members.begin[index + 1]; ++member) {
+      size_t vertex = members.targets[member];
+      keys.insert(keys.end(), symbol.targets.begin() + symbol.begin[vertex],
+                  symbol.targets.begin() + symbol.begin[vertex + 1]);
+      for (size_t edge = epsilon.begin[vertex]; edge < epsilon.begin[vertex + 1]; ++edge) {
+        size_t to = components[epsilon.targets[edge]];
+        if (to == index) {
           continue;
         }
 
-        componentTransitions[index].insert(componentTransitions[components[to]].begin(),
-                                           componentTransitions[components[to]].end());
-        if (hasFinal[components[to]]) hasFinal[index] = true;
+        for (size_t key = keyBegin[to]; key < keyBegin[to + 1]; ++key) {
+          keys.push_back(keys[key]);
+        }
+        hasFinal[index] = hasFinal[index] || hasFinal[to];
+        if (hasPatterns()) {
+          componentPatterns[index].insert(componentPatterns[index].end(), componentPatterns[to].begin(),
+                                          componentPatterns[to].end());
+        }
       }
     }
-  }
 
-  NFA res(m_transitions.size(), m_alphabet);
-  for (size_t vertex = 0; vertex < m_transitions.size(); ++vertex) {
-    for (const auto& [s, to] : componentTransitions[components[vertex]]) {
-      res.addTransition({vertex, s, to});
+    std::sort(keys.begin() + keyBegin[index], keys.end());
+    keys.erase(std::unique(keys.begin() + keyBegin[index], keys.end()), keys.end());
+    keyBegin[index + 1] = keys.size();
+    if (hasPatterns()) {
+      auto& patterns = componentPatterns[index];
+      std::sort(patterns.begin(), patterns.end());
+      patterns.erase(std::unique(patterns.begin(), patterns.end()), patterns.end());
     }
   }
-  for (size_t index = 0; index < num_components; ++index) {
+
+  NFA res(size, m_alphabet);
+  for (size_t label : order) {
+    res.getLabelId(m_labels[label]);
+  }
+  res.m_edges.reserve(symbol.targets.size());
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    size_t index = components[vertex];
+    for (size_t key = keyBegin[index]; key < keyBegin[index + 1]; ++key) {
+      res.m_edges.push_back({vertex, keys[key] >> 32, keys[key] & std::numeric_limits<uint32_t>::max()});
+    }
     if (!hasFinal[index]) {
       continue;
     }
-
-    for (const auto& vertex : componentVertices[index]) {
+    if (!hasPatterns()) {
       res.addFinalState(vertex);
+      continue;
+    }
+    for (size_t pattern : componentPatterns[index]) {
+      res.addFinalState(vertex, pattern);
     }
   }
   return res;
 }
 
-NFA& NFA::operator+=(const NFA& other) { return *this = *this + other; }
+NFA NFA::reduce() const { return trim().mergeBisimilar(false).mergeBisimilar(true); }
 
-NFA& NFA::operator*=(const NFA& other) { return *this = *this * other; }
+NFA& NFA::operator+=(const NFA& other) {
+  if (&other == this) {
+    return *this += NFA(other);
+  }
 
-NFA NFA::operator+(const NFA& other) const {
-  std::string alphabet = m_alphabet + other.m_alphabet;
-  alphabet.resize(std::unique(alphabet.begin(), alphabet.end()) - alphabet.begin());
-  NFA res(m_transitions.size() + other.m_transitions.size() + 1, alphabet);
+  m_patterns.clear();
+  if (!m_startIsolated) {
+    bool empty = getSize() == 0;
+    prependState();
+    if (!empty) {
+      addTransition(0, "", 1);
+    }
+  }
+  size_t shift = getSize();
+  appendShifted(other, shift);
+  if (other.getSize() != 0) {
+    addTransition(0, "", shift);
+  }
+  mergeAlphabet(other.m_alphabet);
+  m_startIsolated = true;
+  return *this;
+}
 
-  for (const auto& [from, s, to] : getTransitions()) {
-    res.addTransition({from + 1, s, to + 1});
+NFA& NFA::operator*=(const NFA& other) {
+  if (&other == this) {
+    return *this *= NFA(other);
   }
-  for (const auto& [from, s, to] : other.getTransitions()) {
-    res.addTransition({from + m_transitions.size() + 1, s, to + m_transitions.size() + 1});
+
+  size_t size = getSize();
+  std::vector<size_t> finals = getFinalStates();
+  m_patterns.clear();
+  mergeAlphabet(other.m_alphabet);
+  if (size == 0) {
+    return *this;
   }
-  res.addTransition({0, "", 1});
-  res.addTransition({0, "", m_transitions.size() + 1});
 
-  for (size_t vertex : getFinalStates()) {
-    res.addFinalState(vertex + 1);
+  m_final.assign(size, false);
+  appendShifted(other, size);
+  for (size_t vertex = 0; other.getSize() != 0 && vertex < finals.size(); ++vertex) {
+    addTransition(finals[vertex], "", size);
   }
-  for (size_t vertex : other.getFinalStates()) {
-    res.addFinalState(vertex + m_transitions.size() + 1);
+  return *this;
+}
+
+NFA NFA::operator+(const NFA& other) const& { return NFA(*this) + other; }
+
+NFA NFA::operator+(const NFA& other) && {
+  *this += other;
+  return std::move(*this);
+}
+
+NFA NFA::operator*(const NFA& other) const& { return NFA(*this) * other; }
+
+NFA NFA::operator*(const NFA& other) && {
+  *this *= other;
+  return std::move(*this);
+}
+
+NFA NFA::operator*() const& { return *NFA(*this); }
+
+NFA NFA::operator*() && {
+  size_t size = getSize();
+  std::vector<size_t> finals = getFinalStates();
+  m_patterns.clear();
+  prependState();
+  m_final.assign(size + 1, false);
+  for (size_t vertex : finals) {
+    addTransition(vertex + 1, "", 0);
+  }
+  if (size != 0) {
+    addTransition(0, "", 1);
   }
+  m_final[0] = true;
+  return std::move(*this);
+}
 
-  return res;
+size_t NFA::addState() {
+  m_final.push_back(false);
+  if (hasPatterns()) {
+    m_patterns.emplace_back();
+  }
+  return getSize() - 1;
 }
 
-NFA NFA::operator*(const NFA& other) const {
-  std::string alphabet = m_alphabet + other.m_alphabet;
-  alphabet.resize(std::unique(alphabet.begin(), alphabet.end()) - alphabet.begin());
-  NFA res(m_transitions.size() + other.m_transitions.size(), alphabet);
+size_t NFA::getLabelId(std::string_view label) {
+  auto it = m_labelIds.find(label);
+  if (it == m_labelIds.end()) {
+    it = m_labelIds.emplace(label, m_labels.size()).first;
+    m_labels.emplace_back(label);
+  }
+  return it->second;
+}
 
-  for (const auto& [from, s, to] : getTransitions()) {
-    res.addTransition({from, s, to});
+void NFA::prependState() {
+  for (auto& edge : m_edges) {
+    ++edge.from;
+    ++edge.to;
   }
-  for (const auto& [from, s, to] : other.getTransitions()) {
-    res.addTransition({from + m_transitions.size(), s, to + m_transitions.size()});
+  m_final.insert(m_final.begin(), false);
+}
+
+void NFA::appendShifted(const NFA& other, size_t shift) {
+  m_final.resize(std::max(getSize(), shift + other.getSize()));
+  std::vector<size_t> labels(other.m_labels.size());
+  for (size_t label = 0; label < labels.size(); ++label) {
+    labels[label] = getLabelId(other.m_labels[label]);
   }
-  for (const auto& vertex : getFinalStates()) {
-    res.addTransition({vertex, "", m_transitions.size()});
+  m_edges.reserve(m_edges.size() + other.m_edges.size());
+  for (const auto& [from, label, to] : other.m_edges) {
+    m_edges.push_back({from + shift, labels[label], to + shift});
   }
-  for (const auto& vertex : other.getFinalStates()) {
-    res.addFinalState(vertex + m_transitions.size());
+  for (size_t vertex : other.getFinalStates()) {
+    m_final[vertex + shift] = true;
   }
+}
+
+void NFA::mergeAlphabet(const std::string& alphabet) {
+  m_alphabet += alphabet;
+  std::sort(m_alphabet.begin(), m_alphabet.end());
+  m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end()), m_alphabet.end());
+}
+
+NFA::Builder::Fragment NFA::Builder::unity() {
+  size_t state = m_nfa.addState();
+  return {state, state};
+}
+
+NFA::Builder::Fragment NFA::Builder::symbol(std::string_view label) {
+  Fragment res{m_nfa.addState(), m_nfa.addState()};
+  m_nfa.addTransition(res.start, label, res.accept);
+  return res;
+}
 
+NFA::Builder::Fragment NFA::Builder::sum(const Fragment& left, const Fragment& right) {
+  Fragment res{m_nfa.addState(), m_nfa.addState()};
+  m_nfa.addTransition(res.start, "", left.start);
+  m_nfa.addTransition(res.start, "", right.start);
+  m_nfa.addTransition(left.accept, "", res.accept);
+  m_nfa.addTransition(right.accept, "", res.accept);
   return res;
 }
 
-NFA NFA::operator*() const {
-  NFA res(m_transitions.size() + 1, m_alphabet);
+NFA::Builder::Fragment NFA::Builder::product(const Fragment& left, const Fragment& right) {
+  m_nfa.addTransition(left.accept, "", right.start);
+  return {left.start, right.accept};
+}
+
+NFA::Builder::Fragment NFA::Builder::star(const Fragment& fragment) {
+  size_t state = m_nfa.addState();
+  m_nfa.addTransition(state, "", fragment.start);
+  m_nfa.addTransition(fragment.accept, "", state);
+  return {state, state};
+}
+
+NFA NFA::Builder::build(const Fragment& fragment, const std::string& alphabet) && {
+  auto relabel = [&fragment](size_t vertex) {
+    return vertex == fragment.start ? 0 : (vertex == 0 ? fragment.start : vertex);
+  };
+  for (auto& edge : m_nfa.m_edges) {
+    edge.from = relabel(edge.from);
+    edge.to = relabel(edge.to);
+  }
+  m_nfa.m_final[relabel(fragment.accept)] = true;
+  m_nfa.m_alphabet = alphabet;
+  return std::move(m_nfa);
+}
 
-  for (const auto& [from, s, to] : getTransitions()) {
-    res.addTransition({from + 1, s, to + 1});
+NFA::Graph NFA::getAdjacency(bool reverse) const {
+  size_t size = getSize();
+  Graph graph{std::vector<size_t>(size + 1), std::vector<size_t>(m_edges.size())};
+  for (const auto& [from, label, to] : m_edges) {
+    ++graph.begin[(reverse ? to : from) + 1];
   }
-  for (const auto& vertex : getFinalStates()) {
-    res.addTransition({vertex + 1, "", 0});
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    graph.begin[vertex + 1] += graph.begin[vertex];
   }
-  res.addTransition({0, "", 1});
-  res.addFinalState(0);
+  std::vector<size_t> next(graph.begin.begin(), graph.begin.end() - 1);
+  for (const auto& [from, label, to] : m_edges) {
+    graph.targets[next[reverse ? to : from]++] = label << 32 | (reverse ? from : to);
+  }
+  return graph;
+}
 
-  return res;
+NFA NFA::trim() const {
+  size_t size = getSize();
+  if (size == 0) {
+    return *this;
+  }
+
+  auto reach = [size](const Graph& graph, std::vector<size_t> queue) {
+    std::vector<bool> reached(size);
+    for (size_t vertex : queue) {
+      reached[vertex] = true;
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+      for (size_t edge = graph.begin[queue[head]]; edge < graph.begin[queue[head] + 1]; ++edge) {
+        size_t to = graph.targets[edge] & std::numeric_limits<uint32_t>::max();
+        if (!reached[to]) {
+          reached[to] = true;
+          queue.push_back(to);
+        }
+      }
+    }
+    return reached;
+  };
+  std::vector<bool> reachable = reach(getAdjacency(false), {0});
+  std::vector<bool> productive = reach(getAdjacency(true), getFinalStates());
+  if (!productive[0]) {
+    return NFA(0, m_alphabet);
+  }
+
+  std::vector<size_t> blocks(size, kNoState);
+  size_t count = 0;
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    if (reachable[vertex] && productive[vertex]) {
+      blocks[vertex] = count++;
+    }
+  }
+  return count == size ? *this : quotient(blocks, count);
 }
 
-NFA::DFSData::DFSData(size_t size)
-    : vertexColors(size, VertexColor::White),
-      timeIn(size),
-      upTime(size),
-      vertexComponents(size),
-      timer(0),
-      componentCnt(0),
-      vertexStack() {}
+NFA NFA::mergeBisimilar(bool backward) const {
+  size_t size = getSize();
+  if (size == 0) {
+    return *this;
+  }
 
-void NFA::DFS(const std::vector<std::vector<size_t>>& graph, size_t vertex, DFSData& data) {
-  data.vertexColors[vertex] = VertexColor::Grey;
-  data.upTime[vertex] = data.timeIn[vertex] = data.timer++;
-  data.vertexStack.push(vertex);
+  Graph neighbours = getAdjacency(backward);
+  Graph dependents = getAdjacency(!backward);
+  std::vector<size_t> blocks(size);
+  std::vector<std::vector<size_t>> members;
+  std::vector<size_t> position(size);
+  std::map<std::tuple<bool, bool, std::vector<size_t>>, size_t> initial;
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    bool final = m_final[vertex] && (!backward || hasPatterns());
+    std::vector<size_t> patterns = final && hasPatterns() ? m_patterns[vertex] : std::vector<size_t>();
+    auto [it, inserted] = initial.try_emplace({backward && vertex == 0, final, std::move(patterns)}, members.size());
+    if (inserted) {
+      members.emplace_back();
+    }
+    blocks[vertex] = it->second;
+    position[vertex] = members[it->second].size();
+    members[it->second].push_back(vertex);
+  }
 
-  for (size_t to : graph[vertex]) {
-    if (data.vertexColors[to] == VertexColor::White) {
-      DFS(graph, to, data);
-      data.upTime[vertex] = std::min(data.upTime[vertex], data.upTime[to]);
-    } else if (data.vertexColors[to] != VertexColor::Purple) {
-      data.upTime[vertex] = std::min(data.upTime[vertex], data.timeIn[to]);
+  std::vector<size_t> pool;
+  std::vector<size_t> offsets;
+  auto appendSignature = [&neighbours, &blocks, &pool, &offsets](size_t vertex) {
+    size_t begin = pool.size();
+    for (size_t edge = neighbours.begin[vertex]; edge < neighbours.begin[vertex + 1]; ++edge) {
+      size_t key = neighbours.targets[edge];
+      pool.push_back((key >> 32) << 32 | blocks[key & std::numeric_limits<uint32_t>::max()]);
     }
+    std::sort(pool.begin() + begin, pool.end());
+    pool.erase(std::unique(pool.begin() + begin, pool.end()), pool.end());
+    offsets.push_back(pool.size());
+    return offsets.size() - 2;
+  };
+  auto signature = [&pool, &offsets](size_t index) {
+    return std::span(pool.data() + offsets[index], pool.data() + offsets[index + 1]);
+  };
+
+  std::vector<size_t> dirty(size);
+  std::iota(dirty.begin(), dirty.end(), 0);
+  std::vector<bool> isDirty(size, true);
+  std::vector<size_t> dirtyCount(members.size());
+  for (size_t block = 0; block < members.size(); ++block) {
+    dirtyCount[block] = members[block].size();
   }
+  std::vector<std::pair<size_t, size_t>> order;
+  std::vector<size_t> runs;
+  std::vector<std::pair<size_t, size_t>> moves;
+  auto lessSignature = [&signature](const auto& lhs, const auto& rhs) {
+    auto left = signature(lhs.second);
+    auto right = signature(rhs.second);
+    return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+  };
+  while (!dirty.empty()) {
+    pool.clear();
+    offsets.assign(1, 0);
+    order.clear();
+    for (size_t vertex : dirty) {
+      size_t index = appendSignature(vertex);
+      size_t hash = signature(index).size();
+      for (size_t key : signature(index)) {
+        hash = (hash ^ key) * 0x9E3779B97F4A7C15ull;
+      }
+      order.emplace_back(blocks[vertex] << 32 | hash >> 32, index);
+    }
+    std::sort(order.begin(), order.end());
+    for (size_t begin = 0, end = 0; begin < order.size(); begin = end) {
+      bool collision = false;
+      for (end = begin + 1; end < order.size() && order[end].first == order[begin].first; ++end) {
+        collision = collision || !std::ranges::equal(signature(order[begin].second), signature(order[end].second));
+      }
+      if (collision) {
+        std::sort(order.begin() + begin, order.begin() + end, lessSignature);
+      }
+    }
 
-  data.vertexColors[vertex] = VertexColor::Black;
-  if (data.timeIn[vertex] == data.upTime[vertex]) {
-    while (data.vertexStack.top() != vertex) {
-      size_t u = data.vertexStack.top();
-      data.vertexStack.pop();
-      data.vertexComponents[u] = data.componentCnt;
-      data.vertexColors[u] = VertexColor::Purple;
+    moves.clear();
+    for (size_t begin = 0, end = 0; begin < order.size(); begin = end) {
+      size_t block = order[begin].first >> 32;
+      runs.clear();
+      for (end = begin; end < order.size() && order[end].first >> 32 == block; ++end) {
+        if (end == begin || !std::ranges::equal(signature(order[end - 1].second), signature(order[end].second))) {
+          runs.push_back(end);
+        }
+      }
+      runs.push_back(end);
+
+      size_t staying = kNoState;
+      if (members[block].size() > end - begin) {
+        size_t reference = appendSignature(members[block][dirtyCount[block]]);
+        for (size_t run = 0; run + 1 < runs.size(); ++run) {
+          if (std::ranges::equal(signature(order[runs[run]].second), signature(reference))) {
+            staying = run;
+          }
+        }
+      } else {
+        for (size_t run = 0; run + 1 < runs.size(); ++run) {
+          if (staying == kNoState || runs[run + 1] - runs[run] > runs[staying + 1] - runs[staying]) {
+            staying = run;
+          }
+        }
+      }
+      dirtyCount[block] = 0;
+      for (size_t run = 0; run + 1 < runs.size(); ++run) {
+        if (run == staying) {
+          continue;
+        }
+        for (size_t index = runs[run]; index < runs[run + 1]; ++index) {
+          moves.emplace_back(dirty[order[index].second], members.size());
+        }
+        members.emplace_back();
+        dirtyCount.push_back(0);
+      }
+    }
+
+    for (size_t vertex : dirty) {
+      isDirty[vertex] = false;
+    }
+    dirty.clear();
+    for (const auto& [vertex, block] : moves) {
+      auto& previous = members[blocks[vertex]];
+      position[previous.back()] = position[vertex];
+      previous[position[vertex]] = previous.back();
+      previous.pop_back();
+      blocks[vertex] = block;
+      position[vertex] = members[block].size();
+      members[block].push_back(vertex);
+    }
+    for (const auto& [vertex, block] : moves) {
+      for (size_t edge = dependents.begin[vertex]; edge < dependents.begin[vertex + 1]; ++edge) {
+        size_t dependent = dependents.targets[edge] & std::numeric_limits<uint32_t>::max();
+        if (isDirty[dependent]) {
+          continue;
+        }
+        isDirty[dependent] = true;
+        dirty.push_back(dependent);
+        auto& group = members[blocks[dependent]];
+        size_t& front = dirtyCount[blocks[dependent]];
+        position[group[front]] = position[dependent];
+        std::swap(group[front], group[position[dependent]]);
+        position[dependent] = front++;
+      }
     }
-    data.vertexStack.pop();
-    data.vertexComponents[vertex] = data.componentCnt++;
-    data.vertexColors[vertex] = VertexColor::Purple;
   }
-}
 
-NFA::Condensation NFA::condensate(const std::vector<std::vector<size_t>>& graph) {
-  size_t size = graph.size();
-  DFSData data(size);
+  std::vector<size_t> renumber(members.size(), kNoState);
+  size_t count = 0;
   for (size_t vertex = 0; vertex < size; ++vertex) {
-    if (data.vertexColors[vertex] == VertexColor::White) {
-      DFS(graph, vertex, data);
+    if (renumber[blocks[vertex]] == kNoState) {
+      renumber[blocks[vertex]] = count++;
+    }
+    blocks[vertex] = renumber[blocks[vertex]];
+  }
+  return count == size ? *this : quotient(blocks, count);
+}
+
+NFA NFA::quotient(const std::vector<size_t>& blocks, size_t count) const {
+  NFA res(count, m_alphabet);
+  res.m_labels = m_labels;
+  res.m_labelIds = m_labelIds;
+  for (const auto& [from, label, to] : m_edges) {
+    if (blocks[from] != kNoState && blocks[to] != kNoState) {
+      res.m_edges.push_back({blocks[from], label, blocks[to]});
+    }
+  }
+  auto key = [](const Edge& edge) { return std::tie(edge.from, edge.label, edge.to); };
+  std::sort(res.m_edges.begin(), res.m_edges.end(),
+            [&key](const Edge& lhs, const Edge& rhs) { return key(lhs) < key(rhs); });
+  res.m_edges.erase(std::unique(res.m_edges.begin(), res.m_edges.end(),
+                                [&key](const Edge& lhs, const Edge& rhs) { return key(lhs) == key(rhs); }),
+                    res.m_edges.end());
+
+  for (size_t vertex : getFinalStates()) {
+    if (blocks[vertex] == kNoState) {
+      continue;
+    }
+    if (!hasPatterns()) {
+      res.addFinalState(blocks[vertex]);
+      continue;
+    }
+    for (size_t pattern : m_patterns[vertex]) {
+      res.addFinalState(blocks[vertex], pattern);
+    }
+  }
+  return res;
+}
+
+NFA::Condensation NFA::condensate(const Graph& graph) {
+  static constexpr size_t kUnvisited = std::numeric_limits<size_t>::max();
+
+  size_t size = graph.begin.size() - 1;
+  std::vector<size_t> timeIn(size, kUnvisited);
+  std::vector<size_t> upTime(size);
+  std::vector<size_t> vertexComponents(size, kUnvisited);
+  std::vector<size_t> vertexStack;
+  std::vector<std::pair<size_t, size_t>> callStack;
+  size_t timer = 0;
+  size_t componentCnt = 0;
+
+  auto enter = [&](size_t vertex) {
+    timeIn[vertex] = upTime[vertex] = timer++;
+    vertexStack.push_back(vertex);
+    callStack.emplace_back(vertex, graph.begin[vertex]);
+  };
+
+  for (size_t root = 0; root < size; ++root) {
+    if (timeIn[root] != kUnvisited) {
+      continue;
+    }
+
+    enter(root);
+    while (!callStack.empty()) {
+      auto [vertex, edge] = callStack.back();
+      if (edge < graph.begin[vertex + 1]) {
+        ++callStack.back().second;
+        size_t to = graph.targets[edge];
+        if (timeIn[to] == kUnvisited) {
+          enter(to);
+        } else if (vertexComponents[to] == kUnvisited) {
+          upTime[vertex] = std::min(upTime[vertex], timeIn[to]);
+        }
+        continue;
+      }
+
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        size_t parent = callStack.back().first;
+        upTime[parent] = std::min(upTime[parent], upTime[vertex]);
+      }
+      if (timeIn[vertex] == upTime[vertex]) {
+        size_t member;
+        do {
+          member = vertexStack.back();
+          vertexStack.pop_back();
+          vertexComponents[member] = componentCnt;
+        } while (member != vertex);
+        ++componentCnt;
+      }
     }
   }
-  return {data.componentCnt, data.vertexComponents};
+  return {componentCnt, vertexComponents};
 }
@@ -0,0 +1,92 @@
+#include "NFASimulator.hpp"
+
+#include <bit>
+
+#include "NFA.hpp"
+
+NFASimulator::NFASimulator(const NFA& nfa)
+    : m_graph(nfa.hasEpsilon() ? SymbolGraph(nfa.throwEpsilon()) : SymbolGraph(nfa)),
+      m_words((m_graph.getSize() + 63) / 64),
+      m_dense(m_graph.getSymbolCount() * m_graph.getSize() * m_words * sizeof(uint64_t) <= kDenseLimit),
+      m_active(m_graph.getSymbolCount() * m_words),
+      m_final(m_words) {
+  if (m_dense) {
+    m_masks.resize(m_graph.getSymbolCount() * m_graph.getSize() * m_words);
+  }
+
+  for (size_t symbol = 0; symbol < m_graph.getSymbolCount(); ++symbol) {
+    for (size_t state = 0; state < m_graph.getSize(); ++state) {
+      auto transitions = m_graph.getTransitions(state, symbol);
+      if (transitions.empty()) {
+        continue;
+      }
+
+      m_active[symbol * m_words + state / 64] |= uint64_t(1) << (state % 64);
+      for (uint32_t to : transitions) {
+        if (!m_dense) {
+          break;
+        }
+        m_masks[(symbol * m_graph.getSize() + state) * m_words + to / 64] |= uint64_t(1) << (to % 64);
+      }
+    }
+  }
+  for (size_t state = 0; state < m_graph.getSize(); ++state) {
+    if (m_graph.isFinal(state)) {
+      m_final[state / 64] |= uint64_t(1) << (state % 64);
+    }
+  }
+}
+
+size_t NFASimulator::getSize() const { return m_graph.getSize(); }
+
+bool NFASimulator::checkWord(std::string_view word) const {
+  if (m_graph.getSize() == 0) {
+    return false;
+  }
+
+  std::vector<uint64_t> current(m_words);
+  std::vector<uint64_t> next(m_words);
+  current[0] = 1;
+  for (char symb : word) {
+    size_t symbol = m_graph.getSymbolIndex(symb);
+    if (symbol == SymbolGraph::kNoSymbol) {
+      return false;
+    }
+
+    step(current, symbol, next);
+    current.swap(next);
+  }
+
+  for (size_t word = 0; word < m_words; ++word) {
+    if ((current[word] & m_final[word]) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const uint64_t* NFASimulator::getMask(size_t symbol, size_t state) const {
+  return m_masks.data() + (symbol * m_graph.getSize() + state) * m_words;
+}
+
+void NFASimulator::step(const std::vector<uint64_t>& current, size_t symbol, std::vector<uint64_t>& next) const {
+  std::fill(next.begin(), next.end(), 0);
+  const uint64_t* active = m_active.data() + symbol * m_words;
+  uint64_t* res = next.data();
+
+  for (size_t word = 0; word < m_words; ++word) {
+    for (uint64_t bits = current[word] & active[word]; bits != 0; bits &= bits - 1) {
+      size_t state = word * 64 + std::countr_zero(bits);
+      if (m_dense) {
+        const uint64_t* mask = getMask(symbol, state);
+        for (size_t index = 0; index < m_words; ++index) {
+          res[index] |= mask[index];
+        }
+      } else {
+        for (uint32_t to : m_graph.getTransitions(state, symbol)) {
+          res[to / 64] |= uint64_t(1) << (to % 64);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#include "PatternSet.hpp"
+
+#include <algorithm>
+
+#include "Expression.hpp"
+
+size_t PatternSet::add(const Expression& expression) { return add(NFA(expression)); }
+
+size_t PatternSet::add(const NFA& nfa) {
+  m_patterns.push_back(nfa);
+  return m_patterns.size() - 1;
+}
+
+size_t PatternSet::getSize() const { return m_patterns.size(); }
+
+NFA PatternSet::toNFA() const {
+  size_t size = 1;
+  std::string alphabet;
+  for (const auto& pattern : m_patterns) {
+    size += pattern.getSize();
+    alphabet += pattern.getAlphabet();
+  }
+  std::sort(alphabet.begin(), alphabet.end());
+  alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+
+  NFA res(size, alphabet);
+  size_t shift = 1;
+  for (size_t index = 0; index < m_patterns.size(); ++index) {
+    const NFA& pattern = m_patterns[index];
+    if (pattern.getSize() == 0) {
+      continue;
+    }
+
+    res.addTransition(0, "", shift);
+    pattern.forEachTransition([&res, shift](size_t from, std::string_view label, size_t to) {
+      res.addTransition(from + shift, label, to + shift);
+    });
+    for (size_t vertex : pattern.getFinalStates()) {
+      res.addFinalState(vertex + shift, index);
+    }
+    shift += pattern.getSize();
+  }
+  return res;
+}
@@ -0,0 +1,78 @@
+#include "Scanner.hpp"
+
+#include "CDFA.hpp"
+#include "DFA.hpp"
+#include "MappedFile.hpp"
+#include "NFA.hpp"
+
+Scanner::Scanner(const CDFA& cdfa, Mode mode)
+    : m_matcher(mode == Mode::Search ? buildSearchAutomaton(cdfa) : cdfa), m_state(0), m_offset(0), m_started(false) {}
+
+Scanner::Scanner(const DFA& dfa, Mode mode) : Scanner(CDFA(dfa), mode) {}
+
+void Scanner::feed(std::string_view chunk, const std::function<void(size_t)>& onMatch) {
+  const uint32_t* table = m_matcher.m_table;
+  const uint16_t* columns = m_matcher.m_columns;
+  uint32_t state = m_state;
+
+  if (!onMatch) {
+    for (unsigned char symb : chunk) {
+      state = table[state + columns[symb]];
+    }
+  } else {
+    if (!m_started && m_matcher.isFinal(state)) {
+      onMatch(0);
+    }
+    for (size_t index = 0; index < chunk.size(); ++index) {
+      state = table[state + columns[static_cast<unsigned char>(chunk[index])]];
+      if (m_matcher.isFinal(state)) {
+        onMatch(m_offset + index + 1);
+      }
+    }
+  }
+
+  m_state = state;
+  m_offset += chunk.size();
+  m_started = true;
+}
+
+void Scanner::feedFile(const std::string& path, const std::function<void(size_t)>& onMatch) {
+  MappedFile file(path);
+  feed(file.getData(), onMatch);
+}
+
+void Scanner::reset() {
+  m_state = 0;
+  m_offset = 0;
+  m_started = false;
+}
+
+bool Scanner::isAccepting() const { return m_matcher.isFinal(m_state); }
+
+size_t Scanner::getOffset() const { return m_offset; }
+
+CDFA Scanner::buildSearchAutomaton(const CDFA& cdfa) {
+  std::string alphabet(256, '\0');
+  for (size_t symb = 0; symb < alphabet.size(); ++symb) {
+    alphabet[symb] = static_cast<char>(symb);
+  }
+
+  NFA nfa(cdfa.getSize() + 1, alphabet);
+  cdfa.forEachTransition([&nfa](size_t from, std::string_view label, size_t to) {
+    nfa.addTransition(from + 1, label, to + 1);
+    if (from == 0) {
+      nfa.addTransition(0, label, to + 1);
+    }
+  });
+  for (char symb : alphabet) {
+    nfa.addTransition(0, std::string_view(&symb, 1), 0);
+  }
+  for (size_t vertex : cdfa.getFinalStates()) {
+    nfa.addFinalState(vertex + 1);
+    if (vertex == 0) {
+      nfa.addFinalState(0);
+    }
+  }
+
+  return CDFA(nfa);
+}
@@ -0,0 +1,130 @@
+#include "StateSet.hpp"
+
+#include <algorithm>
+#include <bit>
+
+SparseSet::SparseSet(size_t capacity) : m_dense(capacity), m_sparse(capacity), m_size(0) {}
+
+bool SparseSet::insert(uint32_t value) {
+  if (contains(value)) {
+    return false;
+  }
+  m_sparse[value] = m_size;
+  m_dense[m_size++] = value;
+  return true;
+}
+
+bool SparseSet::contains(uint32_t value) const { return m_sparse[value] < m_size && m_dense[m_sparse[value]] == value; }
+
+void SparseSet::clear() { m_size = 0; }
+
+size_t SparseSet::size() const { return m_size; }
+
+bool SparseSet::empty() const { return m_size == 0; }
+
+std::span<const uint32_t> SparseSet::values() const { return {m_dense.data(), m_size}; }
+
+StateSetTable::StateSetTable(size_t universe)
+    : m_bitset(universe <= kBitsetUniverse), m_words((universe + 31) / 32) {
+  clear();
+}
+
+void StateSetTable::encode(std::span<const uint32_t> states, std::vector<uint32_t>& key) const {
+  if (m_bitset) {
+    key.assign(m_words, 0);
+    for (uint32_t state : states) {
+      key[state / 32] |= uint32_t(1) << (state % 32);
+    }
+  } else {
+    key.assign(states.begin(), states.end());
+    std::sort(key.begin(), key.end());
+  }
+}
+
+void StateSetTable::decode(size_t id, std::vector<uint32_t>& states) const {
+  std::span<const uint32_t> key = getKey(id);
+  if (!m_bitset) {
+    states.assign(key.begin(), key.end());
+    return;
+  }
+
+  states.clear();
+  for (size_t word = 0; word < key.size(); ++word) {
+    for (uint32_t bits = key[word]; bits != 0; bits &= bits - 1) {
+      states.push_back(word * 32 + std::countr_zero(bits));
+    }
+  }
+}
+
+size_t StateSetTable::find(std::span<const uint32_t> key) const {
+  size_t slot = findSlot(key, hash(key));
+  return m_slots[slot];
+}
+
+std::pair<size_t, bool> StateSetTable::intern(std::span<const uint32_t> key) {
+  size_t keyHash = hash(key);
+  size_t slot = findSlot(key, keyHash);
+  if (m_slots[slot] != kNotFound) {
+    return {m_slots[slot], false};
+  }
+
+  size_t id = size();
+  m_arena.insert(m_arena.end(), key.begin(), key.end());
+  m_offsets.push_back(m_arena.size());
+  m_hashes.push_back(keyHash);
+  m_slots[slot] = id;
+  if (2 * size() > m_slots.size()) {
+    rehash(2 * m_slots.size());
+  }
+  return {id, true};
+}
+
+size_t StateSetTable::size() const { return m_hashes.size(); }
+
+size_t StateSetTable::getMemoryUsage() const {
+  return m_arena.size() * sizeof(uint32_t) + (m_offsets.size() + m_hashes.size() + m_slots.size()) * sizeof(size_t);
+}
+
+void StateSetTable::clear() {
+  m_arena.clear();
+  m_offsets.assign(1, 0);
+  m_hashes.clear();
+  m_slots.assign(16, kNotFound);
+}
+
+size_t StateSetTable::hash(std::span<const uint32_t> key) {
+  uint64_t res = 0xcbf29ce484222325ull ^ key.size();
+  for (uint32_t value : key) {
+    res = (res ^ value) * 0x100000001b3ull;
+    res ^= res >> 29;
+  }
+  return res;
+}
+
+std::span<const uint32_t> StateSetTable::getKey(size_t id) const {
+  return {m_arena.data() + m_offsets[id], m_arena.data() + m_offsets[id + 1]};
+}
+
+size_t StateSetTable::findSlot(std::span<const uint32_t> key, size_t keyHash) const {
+  size_t mask = m_slots.size() - 1;
+  for (size_t slot = keyHash & mask;; slot = (slot + 1) & mask) {
+    size_t id = m_slots[slot];
+    if (id == kNotFound) {
+      return slot;
+    }
+    if (m_hashes[id] == keyHash && std::ranges::equal(getKey(id), key)) {
+      return slot;
+    }
+  }
+}
+
+void StateSetTable::rehash(size_t capacity) {
+  m_slots.assign(capacity, kNotFound);
+  for (size_t id = 0; id < size(); ++id) {
+    size_t slot = m_hashes[id] & (capacity - 1);
+    while (m_slots[slot] != kNotFound) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    m_slots[slot] = id;
+  }
+}
@@ -0,0 +1,78 @@
+#include "SymbolGraph.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+#include "NFA.hpp"
+
+SymbolGraph::SymbolGraph(const NFA& nfa) : m_final(nfa.getSize()) {
+  std::vector<std::tuple<uint32_t, unsigned char, uint32_t>> edges;
+  std::array<bool, 256> present{};
+  size_t size = nfa.getSize();
+  nfa.forEachTransition([&](size_t from, std::string_view label, size_t to) {
+    if (label.empty()) {
+      throw std::invalid_argument("Symbol graph requires an automaton without epsilon transitions");
+    }
+    for (size_t index = 0; index < label.size(); ++index) {
+      size_t start = index == 0 ? from : size - 1;
+      size_t end = index + 1 == label.size() ? to : size++;
+      edges.emplace_back(start, label[index], end);
+      present[static_cast<unsigned char>(label[index])] = true;
+    }
+  });
+  if (size > std::numeric_limits<uint32_t>::max() || edges.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Automaton is too large");
+  }
+
+  m_symbolIndex.fill(kNoSymbol);
+  for (size_t symb = 0; symb < present.size(); ++symb) {
+    if (present[symb]) {
+      m_symbolIndex[symb] = m_symbols.size();
+      m_symbols.push_back(static_cast<char>(symb));
+    }
+  }
+
+  m_begin.assign(size * m_symbols.size() + 1, 0);
+  for (const auto& [from, symb, to] : edges) {
+    ++m_begin[from * m_symbols.size() + m_symbolIndex[symb] + 1];
+  }
+  for (size_t index = 1; index < m_begin.size(); ++index) {
+    m_begin[index] += m_begin[index - 1];
+  }
+
+  m_targets.resize(edges.size());
+  std::vector<uint32_t> next(m_begin.begin(), m_begin.end() - 1);
+  for (const auto& [from, symb, to] : edges) {
+    m_targets[next[from * m_symbols.size() + m_symbolIndex[symb]]++] = to;
+  }
+
+  m_final.resize(size);
+  for (size_t vertex : nfa.getFinalStates()) {
+    m_final[vertex] = true;
+  }
+  if (nfa.hasPatterns()) {
+    m_patterns.resize(size);
+    for (size_t vertex : nfa.getFinalStates()) {
+      m_patterns[vertex] = nfa.getPatterns(vertex);
+    }
+  }
+}
+
+size_t SymbolGraph::getSize() const { return m_final.size(); }
+
+size_t SymbolGraph::getSymbolCount() const { return m_symbols.size(); }
+
+char SymbolGraph::getSymbol(size_t index) const { return m_symbols[index]; }
+
+size_t SymbolGraph::getSymbolIndex(char symb) const { return m_symbolIndex[static_cast<unsigned char>(symb)]; }
+
+bool SymbolGraph::isFinal(size_t state) const { return m_final[state]; }
+
+bool SymbolGraph::hasPatterns() const { return !m_patterns.empty(); }
+
+std::span<const size_t> SymbolGraph::getPatterns(size_t state) const { return m_patterns[state]; }
+
+std::span<const uint32_t> SymbolGraph::getTransitions(size_t state, size_t symbol) const {
+  size_t index = state * m_symbols.size() + symbol;
+  return {m_targets.data() + m_begin[index], m_targets.data() + m_begin[index + 1]};
+}
@@ -0,0 +1,62 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : StateSet.hpp
+ ******************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+class SparseSet {
+ public:
+  explicit SparseSet(size_t capacity);
+
+  bool insert(uint32_t value);
+  bool contains(uint32_t value) const;
+  void clear();
+
+  size_t size() const;
+  bool empty() const;
+  std::span<const uint32_t> values() const;
+
+ private:
+  std::vector<uint32_t> m_dense;
+  std::vector<uint32_t> m_sparse;
+  size_t m_size;
+};
+
+class StateSetTable {
+ public:
+  static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+  static constexpr size_t kBitsetUniverse = 256;
+
+  explicit StateSetTable(size_t universe);
+
+  void encode(std::span<const uint32_t> states, std::vector<uint32_t>& key) const;
+  void decode(size_t id, std::vector<uint32_t>& states) const;
+
+  size_t find(std::span<const uint32_t> key) const;
+  std::pair<size_t, bool> intern(std::span<const uint32_t> key);
+
+  size_t size() const;
+  size_t getMemoryUsage() const;
+  void clear();
+
+ private:
+  bool m_bitset;
+  size_t m_words;
+  std::vector<uint32_t> m_arena;
+  std::vector<size_t> m_offsets;
+  std::vector<size_t> m_hashes;
+  std::vector<size_t> m_slots;
+
+  static size_t hash(std::span<const uint32_t> key);
+
+  std::span<const uint32_t> getKey(size_t id) const;
+  size_t findSlot(std::span<const uint32_t> key, size_t keyHash) const;
+  void rehash(size_t capacity);
+};
@@ -0,0 +1,40 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : SymbolGraph.hpp
+ ******************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "Automaton.hpp"
+
+class NFA;
+
+class SymbolGraph {
+ public:
+  static constexpr size_t kNoSymbol = 256;
+
+  explicit SymbolGraph(const NFA& nfa);
+
+  size_t getSize() const;
+  size_t getSymbolCount() const;
+  char getSymbol(size_t index) const;
+  size_t getSymbolIndex(char symb) const;
+  bool isFinal(size_t state) const;
+  bool hasPatterns() const;
+  std::span<const size_t> getPatterns(size_t state) const;
+
+  std::span<const uint32_t> getTransitions(size_t state, size_t symbol) const;
+
+ private:
+  std::string m_symbols;
+  std::array<uint16_t, 256> m_symbolIndex;
+  std::vector<uint32_t> m_begin;
+  std::vector<uint32_t> m_targets;
+  std::vector<bool> m_final;
+  std::vector<std::vector<size_t>> m_patterns;
+};
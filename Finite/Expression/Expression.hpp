@@ -1,14 +1,23 @@
 #pragma once
 
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 class Automaton;
+class DFA;
 class NFA;
 
 class Expression {
  public:
+  enum class Elimination { Index, Degree, Weight };
+  enum class Construction { Thompson, Derivatives, Glushkov };
+
   explicit Expression(std::string str);
-  explicit Expression(const Automaton& automaton);
+  explicit Expression(const Automaton& automaton, Elimination order = Elimination::Weight);
 
   Expression& operator+=(const Expression& other);
   Expression& operator*=(const Expression& other);
@@ -17,34 +26,41 @@ class Expression {
   Expression operator*(const Expression& other) const;
   Expression operator*() const;
 
-  NFA toNFA() const;
+  NFA toNFA(Construction construction = Construction::Thompson) const;
   std::string toString() const;
 
  private:
+  friend class DFA;
+
   enum class NodeType;
   struct Node;
-  using NodePtr = std::shared_ptr<const Node>;
-
+  class Context;
+  class Derivator;
+  struct Cell;
+  struct DerivativeTable;
+  struct Positions;
+  using NodePtr = const Node*;
+
+  std::shared_ptr<Context> m_context;
   NodePtr m_root;
 
-  Expression();
-  Expression(NodePtr&& ptr);
+  Expression(const std::shared_ptr<Context>& context, NodePtr root);
+
+  NodePtr adopt(const Expression& other) const;
 
-  static std::string prepareExpression(NodeType type, const NodePtr& node);
-  static std::string buildString(const NodePtr& node);
-  
-  static NFA buildNFA(const NodePtr& node);
+  static std::string prepareExpression(NodeType type, NodePtr node);
+  static std::string buildString(NodePtr node);
 
-  static NodePtr add(const NodePtr& left,
-                                         const NodePtr& right);
-  static NodePtr multiply(const NodePtr& left,
-                                              const NodePtr& right);
-  static NodePtr star(const NodePtr& node);
+  static std::string collectAlphabet(NodePtr root);
+  static NFA buildNFA(NodePtr root, const std::string& alphabet);
+  static NFA buildPositionNFA(NodePtr root, const std::string& alphabet);
 
-  static NodePtr parseExpression(const std::string& str, size_t& ind);
-  static NodePtr parseConcatenation(const std::string& str, size_t& ind);
-  static NodePtr parseElement(const std::string& str, size_t& ind);
-  static NodePtr parsePrimitive(const std::string& str, size_t& ind);
+  DerivativeTable buildDerivatives() const;
+
+  NodePtr parseExpression(const std::string& str, size_t& ind);
+  NodePtr parseConcatenation(const std::string& str, size_t& ind);
+  NodePtr parseElement(const std::string& str, size_t& ind);
+  NodePtr parsePrimitive(const std::string& str, size_t& ind);
 };
 
 enum class Expression::NodeType { Unity, Symbol, Star, Product, Sum };
@@ -55,10 +71,64 @@ struct Expression::Node {
   NodePtr left;
   NodePtr right;
 
-  Node();
-  explicit Node(char symb);
-  explicit Node(const NodePtr& node);
-  Node(NodeType type, const NodePtr& left, const NodePtr& right);
+  bool operator==(const Node& other) const = default;
+};
+
+class Expression::Context {
+ public:
+  NodePtr unity();
+  NodePtr symbol(char symb);
+  NodePtr add(NodePtr left, NodePtr right);
+  NodePtr multiply(NodePtr left, NodePtr right);
+  NodePtr star(NodePtr node);
+
+  NodePtr import(NodePtr node);
+
+ private:
+  std::deque<Node> m_nodes;
+  std::vector<NodePtr> m_slots = std::vector<NodePtr>(64);
+  std::mutex m_mutex;
+
+  static size_t hash(const Node& node);
+
+  NodePtr intern(const Node& node);
+  size_t findSlot(const Node& node) const;
+};
+
+class Expression::Derivator {
+ public:
+  Derivator(Context& context, const std::string& alphabet);
+
+  NodePtr normalize(NodePtr node);
+  NodePtr derive(NodePtr node, size_t symbol);
+  bool nullable(NodePtr node);
+
+ private:
+  Context& m_context;
+  const std::string& m_alphabet;
+  std::vector<std::unordered_map<NodePtr, NodePtr>> m_derivatives;
+  std::unordered_map<NodePtr, bool> m_nullable;
+
+  NodePtr product(NodePtr left, NodePtr right);
+  void collectTerms(NodePtr node, std::vector<NodePtr>& terms) const;
+  NodePtr sum(std::vector<NodePtr>& terms);
+};
+
+struct Expression::DerivativeTable {
+  std::string alphabet;
+  std::vector<std::map<char, size_t>> transitions;
+  std::vector<bool> final;
+};
+
+struct Expression::Positions {
+  bool nullable;
+  std::vector<size_t> first;
+  std::vector<size_t> last;
+};
+
+struct Expression::Cell {
+  NodePtr node;
+  size_t weight;
 };
 
 std::ostream& operator<<(std::ostream& out, const Expression& expression);
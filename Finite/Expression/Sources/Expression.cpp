@@ -1,13 +1,15 @@
 #include "Expression.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "NFA.hpp"
 
-Expression::Expression() : m_root(std::make_shared<Node>()) {}
-
-Expression::Expression(std::string str) {
+Expression::Expression(std::string str) : m_context(std::make_shared<Context>()) {
   size_t writeIdx = 0;
   for (char symb : str) {
     if (isspace(symb)) {
@@ -24,55 +26,137 @@ Expression::Expression(std::string str) {
   }
 }
 
-Expression::Expression(const Automaton& automaton) {
-  std::vector<std::vector<Expression>> matrix(automaton.getSize() + 2,
-                                              std::vector<Expression>(automaton.getSize() + 2, Expression(NodePtr())));
-  matrix[automaton.getSize()][0] = Expression();
+Expression::Expression(const Automaton& automaton, Elimination order) : m_context(std::make_shared<Context>()) {
+  size_t size = automaton.getSize();
+  size_t start = size;
+  size_t finish = size + 1;
+  std::vector<std::map<size_t, Cell>> out(size + 2);
+  std::vector<std::set<size_t>> in(size + 2);
+
+  Context& context = *m_context;
+  auto link = [&out, &in, &context](size_t from, size_t to, NodePtr node, size_t weight) {
+    auto [it, inserted] = out[from].try_emplace(to, Cell{node, weight});
+    if (!inserted) {
+      it->second.node = context.add(it->second.node, node);
+      it->second.weight = std::min(it->second.weight, SIZE_MAX - weight) + weight;
+    }
+    in[to].insert(from);
+  };
 
-  for (const auto& v : automaton.getFinalStates()) {
-    matrix[v][automaton.getSize() + 1] = Expression();
+  if (size != 0) {
+    link(start, 0, context.unity(), 0);
+  }
+  for (size_t vertex : automaton.getFinalStates()) {
+    link(vertex, finish, context.unity(), 0);
   }
-  for (const auto& [from, str, to] : automaton.getTransitions()) {
-    Expression exp;
-    for (const auto& symb : str) {
-      exp.m_root = multiply(exp.m_root, std::make_shared<Node>(symb));
+  automaton.forEachTransition([&link, &context](size_t from, std::string_view str, size_t to) {
+    NodePtr node = context.unity();
+    for (char symb : str) {
+      node = context.multiply(node, context.symbol(symb));
+    }
+    link(from, to, node, str.size());
+  });
+
+  auto getPriority = [&out, &in, order](size_t vertex) -> double {
+    if (order == Elimination::Index) {
+      return vertex;
+    }
+    auto loop = out[vertex].find(vertex);
+    double inDegree = in[vertex].size() - (loop != out[vertex].end());
+    double outDegree = out[vertex].size() - (loop != out[vertex].end());
+    if (order == Elimination::Degree) {
+      return inDegree * outDegree;
+    }
+
+    double res = loop == out[vertex].end() ? 0 : loop->second.weight * (inDegree * outDegree - 1);
+    for (size_t from : in[vertex]) {
+      res += from == vertex ? 0 : out[from].at(vertex).weight * (outDegree - 1);
+    }
+    for (const auto& [to, cell] : out[vertex]) {
+      res += to == vertex ? 0 : cell.weight * (inDegree - 1);
     }
-    matrix[from][to] += exp;
+    return res;
+  };
+
+  std::vector<double> priority(size);
+  std::set<std::pair<double, size_t>> queue;
+  for (size_t vertex = 0; vertex < size; ++vertex) {
+    priority[vertex] = getPriority(vertex);
+    queue.emplace(priority[vertex], vertex);
   }
 
-  for (size_t v = 0; v < automaton.getSize(); ++v) {
-    Expression loop = *matrix[v][v];
-    for (size_t from = 0; from < matrix.size(); ++from) {
-      if (from == v) {
-        continue;
+  while (!queue.empty()) {
+    size_t vertex = queue.begin()->second;
+    queue.erase(queue.begin());
+
+    NodePtr loop = context.unity();
+    size_t loopWeight = 0;
+    if (auto it = out[vertex].find(vertex); it != out[vertex].end()) {
+      loop = context.star(it->second.node);
+      loopWeight = it->second.weight;
+      out[vertex].erase(it);
+      in[vertex].erase(vertex);
+    }
+
+    for (size_t from : in[vertex]) {
+      const Cell& head = out[from].at(vertex);
+      NodePtr prefix = context.multiply(head.node, loop);
+      for (const auto& [to, tail] : out[vertex]) {
+        size_t weight = std::min(head.weight, SIZE_MAX - loopWeight) + loopWeight;
+        link(from, to, context.multiply(prefix, tail.node), std::min(weight, SIZE_MAX - tail.weight) + tail.weight);
       }
-      for (size_t to = 0; to < matrix[from].size(); ++to) {
-        if (to == v) {
-          continue;
-        }
-        matrix[from][to] += matrix[from][v] * loop * matrix[v][to];
+    }
+
+    std::vector<size_t> neighbours;
+    for (size_t from : in[vertex]) {
+      out[from].erase(vertex);
+      neighbours.push_back(from);
+    }
+    for (const auto& [to, cell] : out[vertex]) {
+      in[to].erase(vertex);
+      neighbours.push_back(to);
+    }
+    out[vertex].clear();
+    in[vertex].clear();
+
+    for (size_t neighbour : neighbours) {
+      if (neighbour >= size || !queue.erase({priority[neighbour], neighbour})) {
+        continue;
       }
+      priority[neighbour] = getPriority(neighbour);
+      queue.emplace(priority[neighbour], neighbour);
     }
   }
 
-  *this = matrix[automaton.getSize()][automaton.getSize() + 1];
+  auto it = out[start].find(finish);
+  m_root = it == out[start].end() ? nullptr : it->second.node;
 }
 
 Expression& Expression::operator+=(const Expression& other) { return *this = *this + other; }
 
 Expression& Expression::operator*=(const Expression& other) { return *this = *this * other; }
 
-Expression Expression::operator+(const Expression& other) const { return {add(m_root, other.m_root)}; }
+Expression Expression::operator+(const Expression& other) const {
+  NodePtr right = adopt(other);
+  return {m_context, m_context->add(m_root, right)};
+}
 
-Expression Expression::operator*(const Expression& other) const { return {multiply(m_root, other.m_root)}; }
+Expression Expression::operator*(const Expression& other) const {
+  NodePtr right = adopt(other);
+  return {m_context, m_context->multiply(m_root, right)};
+}
 
-Expression Expression::operator*() const { return {star(m_root)}; }
+Expression Expression::operator*() const { return {m_context, m_context->star(m_root)}; }
 
 std::string Expression::toString() const { return buildString(m_root); }
 
-Expression::Expression(NodePtr&& ptr) : m_root(std::move(ptr)) {}
+Expression::Expression(const std::shared_ptr<Context>& context, NodePtr root) : m_context(context), m_root(root) {}
+
+Expression::NodePtr Expression::adopt(const Expression& other) const {
+  return other.m_context == m_context ? other.m_root : m_context->import(other.m_root);
+}
 
-std::string Expression::prepareExpression(NodeType type, const NodePtr& node) {
+std::string Expression::prepareExpression(NodeType type, NodePtr node) {
   std::string res = buildString(node);
   if (node->type > type) {
     res = "(" + res + ")";
@@ -80,7 +164,7 @@ std::string Expression::prepareExpression(NodeType type, const NodePtr& node) {
   return res;
 }
 
-std::string Expression::buildString(const NodePtr& node) {
+std::string Expression::buildString(NodePtr node) {
   if (!node) {
     return "0";
   }
@@ -101,75 +185,194 @@ std::string Expression::buildString(const NodePtr& node) {
   }
 }
 
-NFA Expression::toNFA() const {
-  std::unordered_set<char> alphas;
-  for (const auto& symb : toString()) {
-    if (std::isalpha(symb)) {
-      alphas.insert(symb);
+NFA Expression::toNFA(Construction construction) const {
+  if (construction == Construction::Thompson) {
+    return buildNFA(m_root, collectAlphabet(m_root));
+  }
+  if (construction == Construction::Glushkov) {
+    return buildPositionNFA(m_root, collectAlphabet(m_root));
+  }
+
+  DerivativeTable table = buildDerivatives();
+  NFA nfa(table.final.size(), table.alphabet);
+  for (size_t from = 0; from < table.transitions.size(); ++from) {
+    for (const auto& [symb, to] : table.transitions[from]) {
+      nfa.addTransition(from, std::string_view(&symb, 1), to);
+    }
+    if (table.final[from]) {
+      nfa.addFinalState(from);
     }
   }
+  return nfa;
+}
 
+std::string Expression::collectAlphabet(NodePtr root) {
   std::string alphabet;
-  for (const auto& symb : alphas) {
-    alphabet.push_back(symb);
+  std::unordered_set<NodePtr> visited;
+  std::vector<NodePtr> stack;
+  if (root) {
+    stack.push_back(root);
+  }
+  while (!stack.empty()) {
+    NodePtr node = stack.back();
+    stack.pop_back();
+    if (!visited.insert(node).second) {
+      continue;
+    }
+    if (node->type == NodeType::Symbol) {
+      alphabet.push_back(node->sym);
+    }
+    for (NodePtr child : {node->left, node->right}) {
+      if (child) {
+        stack.push_back(child);
+      }
+    }
   }
   std::sort(alphabet.begin(), alphabet.end());
+  alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+  return alphabet;
+}
 
-  NFA empty = buildNFA(m_root);
-
-  NFA ret(empty.getSize(), alphabet);
-  for (const auto& state : empty.getFinalStates()) {
-    ret.addFinalState(state);
-  }
-  for (const auto& transition : empty.getTransitions()) {
-    ret.addTransition(transition);
+NFA Expression::buildNFA(NodePtr root, const std::string& alphabet) {
+  if (!root) {
+    return NFA(0, alphabet);
   }
 
-  return ret;
+  NFA::Builder builder;
+  auto build = [&builder](const auto& self, NodePtr node) -> NFA::Builder::Fragment {
+    switch (node->type) {
+      case NodeType::Unity:
+        return builder.unity();
+      case NodeType::Symbol:
+        return builder.symbol(std::string(1, node->sym));
+      case NodeType::Star:
+        return builder.star(self(self, node->left));
+      case NodeType::Sum: {
+        auto left = self(self, node->left);
+        return builder.sum(left, self(self, node->right));
+      }
+      case NodeType::Product: {
+        auto left = self(self, node->left);
+        return builder.product(left, self(self, node->right));
+      }
+      default:
+        throw std::runtime_error("Unknown NodeType");
+    }
+  };
+  auto fragment = build(build, root);
+  return std::move(builder).build(fragment, alphabet);
 }
 
-NFA Expression::buildNFA(const NodePtr& node) {
-  if (!node) {
-    return NFA(0, "");
+NFA Expression::buildPositionNFA(NodePtr root, const std::string& alphabet) {
+  if (!root) {
+    return NFA(0, alphabet);
   }
-  switch (node->type) {
-    case NodeType::Unity: {
-      NFA unity(1, "");
-      unity.addFinalState(0);
-      return unity;
+
+  std::vector<char> symbols(1);
+  std::vector<std::pair<size_t, size_t>> follow;
+  auto link = [&follow](const std::vector<size_t>& from, const std::vector<size_t>& to) {
+    for (size_t last : from) {
+      for (size_t first : to) {
+        follow.emplace_back(last, first);
+      }
     }
-    case NodeType::Symbol: {
-      NFA symbol(2, "");
-      symbol.addTransition({0, std::string(1, node->sym), 1});
-      symbol.addFinalState(1);
-      return symbol;
+  };
+  auto visit = [&symbols, &link](const auto& self, NodePtr node) -> Positions {
+    switch (node->type) {
+      case NodeType::Unity:
+        return {true, {}, {}};
+      case NodeType::Symbol:
+        symbols.push_back(node->sym);
+        return {false, {symbols.size() - 1}, {symbols.size() - 1}};
+      case NodeType::Star: {
+        Positions res = self(self, node->left);
+        link(res.last, res.first);
+        res.nullable = true;
+        return res;
+      }
+      case NodeType::Sum: {
+        Positions res = self(self, node->left);
+        Positions right = self(self, node->right);
+        res.nullable = res.nullable || right.nullable;
+        res.first.insert(res.first.end(), right.first.begin(), right.first.end());
+        res.last.insert(res.last.end(), right.last.begin(), right.last.end());
+        return res;
+      }
+      case NodeType::Product: {
+        Positions left = self(self, node->left);
+        Positions right = self(self, node->right);
+        link(left.last, right.first);
+        Positions res{left.nullable && right.nullable, std::move(left.first), std::move(right.last)};
+        if (left.nullable) {
+          res.first.insert(res.first.end(), right.first.begin(), right.first.end());
+        }
+        if (right.nullable) {
+          res.last.insert(res.last.end(), left.last.begin(), left.last.end());
+        }
+        return res;
+      }
+      default:
+        throw std::runtime_error("Unknown NodeType");
+    }
+  };
+  Positions positions = visit(visit, root);
+  link({0}, positions.first);
+  std::sort(follow.begin(), follow.end());
+  follow.erase(std::unique(follow.begin(), follow.end()), follow.end());
+
+  NFA nfa(symbols.size(), alphabet);
+  for (const auto& [from, to] : follow) {
+    nfa.addTransition(from, std::string_view(&symbols[to], 1), to);
+  }
+  if (positions.nullable) {
+    nfa.addFinalState(0);
+  }
+  for (size_t position : positions.last) {
+    nfa.addFinalState(position);
+  }
+  return nfa;
+}
+
+Expression::DerivativeTable Expression::buildDerivatives() const {
+  DerivativeTable table{collectAlphabet(m_root), {}, {}};
+  Context context;
+  Derivator derivator(context, table.alphabet);
+
+  std::vector<NodePtr> states{derivator.normalize(context.import(m_root))};
+  std::unordered_map<NodePtr, size_t> index{{states[0], 0}};
+  for (size_t current = 0; current < states.size(); ++current) {
+    table.final.push_back(derivator.nullable(states[current]));
+    auto& transitions = table.transitions.emplace_back();
+    for (size_t symbol = 0; symbol < table.alphabet.size() && states[current]; ++symbol) {
+      NodePtr next = derivator.derive(states[current], symbol);
+      if (!next) {
+        continue;
+      }
+      auto [it, inserted] = index.try_emplace(next, states.size());
+      if (inserted) {
+        states.push_back(next);
+      }
+      transitions.emplace_hint(transitions.end(), table.alphabet[symbol], it->second);
     }
-    case NodeType::Star:
-      return *buildNFA(node->left);
-    case NodeType::Sum:
-      return buildNFA(node->left) + buildNFA(node->right);
-    case NodeType::Product:
-      return buildNFA(node->left) * buildNFA(node->right);
-      break;
-    default:
-      throw std::runtime_error("Unknown NodeType");
   }
+  return table;
 }
 
-Expression::NodePtr Expression::add(const NodePtr& left, const NodePtr& right) {
-  if (!left) {
+Expression::NodePtr Expression::Context::unity() { return intern({NodeType::Unity, 0, nullptr, nullptr}); }
+
+Expression::NodePtr Expression::Context::symbol(char symb) { return intern({NodeType::Symbol, symb, nullptr, nullptr}); }
+
+Expression::NodePtr Expression::Context::add(NodePtr left, NodePtr right) {
+  if (!left || left == right) {
     return right;
   }
   if (!right) {
     return left;
   }
-  if (left->type == NodeType::Unity && right->type == NodeType::Unity) {
-    return left;
-  }
-  return std::make_shared<const Node>(NodeType::Sum, left, right);
+  return intern({NodeType::Sum, 0, left, right});
 }
 
-Expression::NodePtr Expression::multiply(const NodePtr& left, const NodePtr& right) {
+Expression::NodePtr Expression::Context::multiply(NodePtr left, NodePtr right) {
   if (!left || !right) {
     return nullptr;
   }
@@ -179,23 +382,181 @@ Expression::NodePtr Expression::multiply(const NodePtr& left, const NodePtr& rig
   if (right->type == NodeType::Unity) {
     return left;
   }
-  return std::make_shared<const Node>(NodeType::Product, left, right);
+  return intern({NodeType::Product, 0, left, right});
 }
 
-Expression::NodePtr Expression::star(const NodePtr& node) {
+Expression::NodePtr Expression::Context::star(NodePtr node) {
   if (!node) {
-    return std::make_shared<const Node>();
+    return unity();
   }
   if (node->type == NodeType::Unity || node->type == NodeType::Star) {
     return node;
   }
-  return std::make_shared<const Node>(node);
+  return intern({NodeType::Star, 0, node, nullptr});
+}
+
+Expression::NodePtr Expression::Context::import(NodePtr root) {
+  std::unordered_map<NodePtr, NodePtr> imported{{nullptr, nullptr}};
+  auto visit = [this, &imported](const auto& self, NodePtr node) -> NodePtr {
+    auto it = imported.find(node);
+    if (it != imported.end()) {
+      return it->second;
+    }
+    Node copy{node->type, node->sym, self(self, node->left), self(self, node->right)};
+    return imported[node] = intern(copy);
+  };
+  return visit(visit, root);
+}
+
+size_t Expression::Context::hash(const Node& node) {
+  uint64_t res = 0xcbf29ce484222325ull ^ (static_cast<uint64_t>(node.type) << 8 | static_cast<unsigned char>(node.sym));
+  for (NodePtr child : {node.left, node.right}) {
+    res = (res ^ reinterpret_cast<uintptr_t>(child)) * 0x100000001b3ull;
+    res ^= res >> 29;
+  }
+  return res;
+}
+
+Expression::NodePtr Expression::Context::intern(const Node& node) {
+  std::lock_guard lock(m_mutex);
+  size_t slot = findSlot(node);
+  if (m_slots[slot]) {
+    return m_slots[slot];
+  }
+
+  m_slots[slot] = &m_nodes.emplace_back(node);
+  if (2 * m_nodes.size() > m_slots.size()) {
+    m_slots.assign(2 * m_slots.size(), nullptr);
+    for (const Node& existing : m_nodes) {
+      m_slots[findSlot(existing)] = &existing;
+    }
+  }
+  return &m_nodes.back();
+}
+
+size_t Expression::Context::findSlot(const Node& node) const {
+  size_t slot = hash(node) & (m_slots.size() - 1);
+  while (m_slots[slot] && !(*m_slots[slot] == node)) {
+    slot = (slot + 1) & (m_slots.size() - 1);
+  }
+  return slot;
+}
+
+Expression::Derivator::Derivator(Context& context, const std::string& alphabet)
+    : m_context(context), m_alphabet(alphabet), m_derivatives(alphabet.size()) {}
+
+Expression::NodePtr Expression::Derivator::normalize(NodePtr node) {
+  std::vector<NodePtr> terms;
+  collectTerms(node, terms);
+  return sum(terms);
+}
+
+Expression::NodePtr Expression::Derivator::derive(NodePtr node, size_t symbol) {
+  if (!node) {
+    return nullptr;
+  }
+  auto it = m_derivatives[symbol].find(node);
+  if (it != m_derivatives[symbol].end()) {
+    return it->second;
+  }
+
+  NodePtr res = nullptr;
+  switch (node->type) {
+    case NodeType::Unity:
+      break;
+    case NodeType::Symbol:
+      res = node->sym == m_alphabet[symbol] ? m_context.unity() : nullptr;
+      break;
+    case NodeType::Star:
+      res = product(derive(node->left, symbol), node);
+      break;
+    case NodeType::Product: {
+      std::vector<NodePtr> terms;
+      collectTerms(product(derive(node->left, symbol), node->right), terms);
+      if (nullable(node->left)) {
+        collectTerms(derive(node->right, symbol), terms);
+      }
+      res = sum(terms);
+      break;
+    }
+    case NodeType::Sum: {
+      std::vector<NodePtr> terms;
+      std::vector<NodePtr> derivatives;
+      collectTerms(node, terms);
+      for (NodePtr term : terms) {
+        collectTerms(derive(term, symbol), derivatives);
+      }
+      res = sum(derivatives);
+      break;
+    }
+    default:
+      throw std::runtime_error("Unknown NodeType");
+  }
+  return m_derivatives[symbol][node] = res;
+}
+
+bool Expression::Derivator::nullable(NodePtr node) {
+  if (!node) {
+    return false;
+  }
+  auto it = m_nullable.find(node);
+  if (it != m_nullable.end()) {
+    return it->second;
+  }
+
+  bool res = false;
+  switch (node->type) {
+    case NodeType::Unity:
+    case NodeType::Star:
+      res = true;
+      break;
+    case NodeType::Symbol:
+      res = false;
+      break;
+    case NodeType::Product:
+      res = nullable(node->left) && nullable(node->right);
+      break;
+    case NodeType::Sum:
+      res = nullable(node->left) || nullable(node->right);
+      break;
+    default:
+      throw std::runtime_error("Unknown NodeType");
+  }
+  return m_nullable[node] = res;
+}
+
+Expression::NodePtr Expression::Derivator::product(NodePtr left, NodePtr right) {
+  if (left && left->type == NodeType::Product) {
+    return product(left->left, product(left->right, right));
+  }
+  return m_context.multiply(left, right);
+}
+
+void Expression::Derivator::collectTerms(NodePtr node, std::vector<NodePtr>& terms) const {
+  while (node && node->type == NodeType::Sum) {
+    collectTerms(node->left, terms);
+    node = node->right;
+  }
+  if (node) {
+    terms.push_back(node);
+  }
+}
+
+Expression::NodePtr Expression::Derivator::sum(std::vector<NodePtr>& terms) {
+  std::sort(terms.begin(), terms.end(), std::less<NodePtr>());
+  terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+  NodePtr res = nullptr;
+  for (auto it = terms.rbegin(); it != terms.rend(); ++it) {
+    res = res ? m_context.add(*it, res) : *it;
+  }
+  return res;
 }
 
 Expression::NodePtr Expression::parseExpression(const std::string& str, size_t& ind) {
   NodePtr res = parseConcatenation(str, ind);
   if (ind < str.size() && str[ind] == '+') {
-    res = add(res, parseExpression(str, ++ind));
+    NodePtr right = parseExpression(str, ++ind);
+    res = m_context->add(res, right);
   }
   return res;
 }
@@ -203,7 +564,8 @@ Expression::NodePtr Expression::parseExpression(const std::string& str, size_t&
 Expression::NodePtr Expression::parseConcatenation(const std::string& str, size_t& ind) {
   NodePtr res = parseElement(str, ind);
   if (ind < str.size() && str[ind] == '.') {
-    res = multiply(res, parseConcatenation(str, ++ind));
+    NodePtr right = parseConcatenation(str, ++ind);
+    res = m_context->multiply(res, right);
   }
   return res;
 }
@@ -211,7 +573,7 @@ Expression::NodePtr Expression::parseConcatenation(const std::string& str, size_
 Expression::NodePtr Expression::parseElement(const std::string& str, size_t& ind) {
   NodePtr res = parsePrimitive(str, ind);
   if (ind < str.size() && str[ind] == '*') {
-    res = star(res);
+    res = m_context->star(res);
     ++ind;
   }
   return res;
@@ -219,16 +581,16 @@ Expression::NodePtr Expression::parseElement(const std::string& str, size_t& ind
 
 Expression::NodePtr Expression::parsePrimitive(const std::string& str, size_t& ind) {
   if (ind == str.size()) throw std::invalid_argument("Incorrect input string");
-  NodePtr res;
+  NodePtr res = nullptr;
   if (str[ind] == '(') {
     res = parseExpression(str, ++ind);
     if (ind == str.size() || str[ind] != ')') {
       throw std::invalid_argument("Incorrect input string");
     }
   } else if (str[ind] == '1') {
-    res = std::make_shared<Node>();
+    res = m_context->unity();
   } else if (('a' <= str[ind] && str[ind] <= 'z') || ('A' <= str[ind] && str[ind] <= 'Z')) {
-    res = std::make_shared<Node>(str[ind]);
+    res = m_context->symbol(str[ind]);
   } else if (str[ind] != '0') {
     throw std::invalid_argument("Incorrect input string");
   }
@@ -237,15 +599,6 @@ Expression::NodePtr Expression::parsePrimitive(const std::string& str, size_t& i
   return res;
 }
 
-Expression::Node::Node() : type(NodeType::Unity), sym() {}
-
-Expression::Node::Node(char symb) : type(NodeType::Symbol), sym(symb) {}
-
-Expression::Node::Node(NodeType type, const NodePtr& left, const NodePtr& right)
-    : type(type), sym(), left(left), right(right) {}
-
-Expression::Node::Node(const NodePtr& node) : type(NodeType::Star), sym(), left(node), right() {}
-
 std::ostream& operator<<(std::ostream& out, const Expression& expression) {
   out << expression.toString();
   return out;
@@ -0,0 +1,296 @@
+/******************************************
+ *  Author : NThemeDEV
+ *  Created : Sun Oct 18 2026
+ *  File : StaticExpression.hpp
+ ******************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+template <size_t N>
+struct FixedString {
+  std::array<char, N> data;
+
+  constexpr FixedString(const char (&str)[N]) { std::copy_n(str, N, data.begin()); }
+
+  constexpr std::string_view view() const { return {data.data(), N - 1}; }
+};
+
+class StaticCompiler {
+ public:
+  struct Table;
+
+  static constexpr Table compile(std::string_view pattern);
+
+ private:
+  struct PositionSet;
+  struct Parser;
+  struct Fragment;
+};
+
+struct StaticCompiler::Table {
+  std::array<uint8_t, 256> columns;
+  size_t stride;
+  std::vector<size_t> transitions;
+  std::vector<bool> final;
+
+  constexpr size_t getSize() const { return final.size(); }
+};
+
+struct StaticCompiler::PositionSet {
+  std::vector<uint64_t> words;
+
+  constexpr explicit PositionSet(size_t universe) : words((universe + 63) / 64) {}
+
+  constexpr void insert(size_t position) { words[position / 64] |= uint64_t{1} << (position % 64); }
+  constexpr bool contains(size_t position) const { return (words[position / 64] >> (position % 64) & 1) != 0; }
+
+  constexpr void unite(const PositionSet& other) {
+    for (size_t index = 0; index < words.size(); ++index) {
+      words[index] |= other.words[index];
+    }
+  }
+
+  constexpr bool operator==(const PositionSet& other) const = default;
+};
+
+struct StaticCompiler::Fragment {
+  bool nullable;
+  PositionSet first;
+  PositionSet last;
+};
+
+struct StaticCompiler::Parser {
+  std::string str;
+  size_t ind;
+  std::vector<char> symbols;
+  std::vector<PositionSet> follow;
+
+  constexpr explicit Parser(std::string_view pattern) : ind(0), symbols(1) {
+    for (char symb : pattern) {
+      if (symb != ' ' && symb != '\t' && symb != '\n' && symb != '\r' && symb != '\f' && symb != '\v') {
+        str.push_back(symb);
+      }
+    }
+    size_t universe = 1 + std::count_if(str.begin(), str.end(), isSymbol);
+    follow.assign(universe, PositionSet(universe));
+  }
+
+  static constexpr bool isSymbol(char symb) { return ('a' <= symb && symb <= 'z') || ('A' <= symb && symb <= 'Z'); }
+
+  constexpr Fragment parseExpression() {
+    Fragment res = parseConcatenation();
+    if (ind < str.size() && str[ind] == '+') {
+      ++ind;
+      Fragment other = parseExpression();
+      res.nullable = res.nullable || other.nullable;
+      res.first.unite(other.first);
+      res.last.unite(other.last);
+    }
+    return res;
+  }
+
+  constexpr Fragment parseConcatenation() {
+    Fragment res = parseElement();
+    if (ind < str.size() && str[ind] == '.') {
+      ++ind;
+      Fragment other = parseConcatenation();
+      link(res.last, other.first);
+      if (res.nullable) {
+        res.first.unite(other.first);
+      }
+      if (other.nullable) {
+        other.last.unite(res.last);
+      }
+      res.last = other.last;
+      res.nullable = res.nullable && other.nullable;
+    }
+    return res;
+  }
+
+  constexpr Fragment parseElement() {
+    Fragment res = parsePrimitive();
+    if (ind < str.size() && str[ind] == '*') {
+      link(res.last, res.first);
+      res.nullable = true;
+      ++ind;
+    }
+    return res;
+  }
+
+  constexpr Fragment parsePrimitive() {
+    if (ind == str.size()) {
+      throw std::invalid_argument("Incorrect input string");
+    }
+    Fragment res{false, PositionSet(follow.size()), PositionSet(follow.size())};
+    if (str[ind] == '(') {
+      ++ind;
+      res = parseExpression();
+      if (ind == str.size() || str[ind] != ')') {
+        throw std::invalid_argument("Incorrect input string");
+      }
+    } else if (str[ind] == '1') {
+      res.nullable = true;
+    } else if (isSymbol(str[ind])) {
+      res.first.insert(symbols.size());
+      res.last.insert(symbols.size());
+      symbols.push_back(str[ind]);
+    } else if (str[ind] != '0') {
+      throw std::invalid_argument("Incorrect input string");
+    }
+    ++ind;
+    return res;
+  }
+
+  constexpr void link(const PositionSet& from, const PositionSet& to) {
+    for (size_t position = 1; position < follow.size(); ++position) {
+      if (from.contains(position)) {
+        follow[position].unite(to);
+      }
+    }
+  }
+};
+
+constexpr StaticCompiler::Table StaticCompiler::compile(std::string_view pattern) {
+  Parser parser(pattern);
+  Fragment root = parser.parseExpression();
+  if (parser.ind < parser.str.size()) {
+    throw std::invalid_argument("Incorrect input string");
+  }
+
+  size_t universe = parser.follow.size();
+  parser.follow[0] = root.first;
+  PositionSet accepting = root.last;
+  if (root.nullable) {
+    accepting.insert(0);
+  }
+
+  Table res{};
+  std::vector<char> alphabet;
+  for (size_t position = 1; position < universe; ++position) {
+    if (std::find(alphabet.begin(), alphabet.end(), parser.symbols[position]) == alphabet.end()) {
+      alphabet.push_back(parser.symbols[position]);
+    }
+  }
+  std::sort(alphabet.begin(), alphabet.end());
+  res.columns.fill(alphabet.size());
+  for (size_t index = 0; index < alphabet.size(); ++index) {
+    res.columns[static_cast<unsigned char>(alphabet[index])] = index;
+  }
+  res.stride = alphabet.size() + 1;
+
+  PositionSet start(universe);
+  start.insert(0);
+  std::vector<PositionSet> states{start, PositionSet(universe)};
+  std::vector<size_t> transitions;
+  for (size_t state = 0; state < states.size(); ++state) {
+    for (size_t column = 0; column < res.stride; ++column) {
+      PositionSet next(universe);
+      for (size_t position = 0; column < alphabet.size() && position < universe; ++position) {
+        if (!states[state].contains(position)) {
+          continue;
+        }
+        for (size_t to = 1; to < universe; ++to) {
+          if (parser.follow[position].contains(to) && parser.symbols[to] == alphabet[column]) {
+            next.insert(to);
+          }
+        }
+      }
+      auto iter = std::find(states.begin(), states.end(), next);
+      transitions.push_back(iter - states.begin());
+      if (iter == states.end()) {
+        states.push_back(next);
+      }
+    }
+  }
+
+  std::vector<bool> final(states.size());
+  std::vector<size_t> block(states.size());
+  size_t blockCount = 0;
+  for (size_t state = 0; state < states.size(); ++state) {
+    for (size_t position = 0; position < universe; ++position) {
+      final[state] = final[state] || (states[state].contains(position) && accepting.contains(position));
+    }
+    block[state] = final[state] ? 1 : 0;
+    blockCount = std::max(blockCount, block[state] + 1);
+  }
+
+  while (true) {
+    std::vector<std::vector<size_t>> signatures;
+    std::vector<size_t> next(states.size());
+    for (size_t state = 0; state < states.size(); ++state) {
+      std::vector<size_t> signature{block[state]};
+      for (size_t column = 0; column < res.stride; ++column) {
+        signature.push_back(block[transitions[state * res.stride + column]]);
+      }
+      auto iter = std::find(signatures.begin(), signatures.end(), signature);
+      next[state] = iter - signatures.begin();
+      if (iter == signatures.end()) {
+        signatures.push_back(signature);
+      }
+    }
+    block = next;
+    if (signatures.size() == blockCount) {
+      break;
+    }
+    blockCount = signatures.size();
+  }
+
+  res.transitions.assign(blockCount * res.stride, 0);
+  res.final.assign(blockCount, false);
+  for (size_t state = 0; state < states.size(); ++state) {
+    for (size_t column = 0; column < res.stride; ++column) {
+      res.transitions[block[state] * res.stride + column] = block[transitions[state * res.stride + column]];
+    }
+    res.final[block[state]] = final[state];
+  }
+  return res;
+}
+
+template <FixedString Pattern>
+class StaticExpression {
+ public:
+  static constexpr size_t getSize() { return kSize; }
+
+  static constexpr bool matches(std::string_view word) {
+    Offset offset = 0;
+    for (unsigned char symb : word) {
+      offset = kData.table[offset + kData.columns[symb]];
+    }
+    return kData.final[offset / kStride];
+  }
+
+ private:
+  static constexpr size_t kSize = StaticCompiler::compile(Pattern.view()).getSize();
+  static constexpr size_t kStride = StaticCompiler::compile(Pattern.view()).stride;
+
+  using Offset = std::conditional_t<kSize * kStride <= UINT16_MAX, uint16_t, uint32_t>;
+
+  struct Data {
+    std::array<uint8_t, 256> columns;
+    std::array<Offset, kSize * kStride> table;
+    std::array<bool, kSize> final;
+  };
+
+  static constexpr Data kData = [] {
+    StaticCompiler::Table compiled = StaticCompiler::compile(Pattern.view());
+    Data res{};
+    res.columns = compiled.columns;
+    for (size_t index = 0; index < res.table.size(); ++index) {
+      res.table[index] = compiled.transitions[index] * kStride;
+    }
+    std::copy(compiled.final.begin(), compiled.final.end(), res.final.begin());
+    return res;
+  }();
+};
+
+template <FixedString Pattern>
+using static_regex = StaticExpression<Pattern>;
@@ -6,8 +6,24 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "AntichainChecker.hpp"
+#include "CDFA.hpp"
+#include "CodeGenerator.hpp"
+#include "DFA.hpp"
+#include "Expression.hpp"
+#include "LazyDFA.hpp"
+#include "Matcher.hpp"
+#include "NFA.hpp"
+#include "NFASimulator.hpp"
 #include "ParserEarley.hpp"
 #include "ParserLR1.hpp"
+#include "PatternSet.hpp"
+#include "Scanner.hpp"
+#include "StaticExpression.hpp"
 
 enum class ParserSelect { EARLEY, LR1 };
 
@@ -87,6 +103,18 @@ bool testF(ParserSelect parser, const std::string& word) {
   return false;
 }
 
+bool testMatcher(const std::string& expression, const std::vector<std::string>& words) {
+  DFA dfa((Expression(expression)));
+  Matcher matcher(dfa);
+  Matcher compressed((CDFA(dfa)));
+  for (const auto& word : words) {
+    if (matcher.checkWord(word) != dfa.checkWord(word) || compressed.checkWord(word) != dfa.checkWord(word)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 TEST(EarleyTest, RuleException) { test0(); }
 
 TEST(EarleyTest, UtilException) { test1(); }
@@ -114,3 +142,420 @@ TEST(LR1Test, FindException) { test4(); }
 TEST(LR1Test, StatementsY) { ASSERT_EQ(testF(ParserSelect::LR1, "aababb"), true); }
 
 TEST(LR1Test, StatementsN) { ASSERT_EQ(testF(ParserSelect::LR1, "aabbba"), false); }
+
+TEST(MatcherTest, SameAsDFA) {
+  ASSERT_EQ(testMatcher("(a+b)*.a.b.b", {"", "abb", "aabb", "abab", "babb", "bbbbabb", "abba"}), true);
+}
+
+TEST(MatcherTest, ForeignSymbols) {
+  ASSERT_EQ(testMatcher("a*.b", {"b", "aab", "acb", "c", "ab\xff", std::string(1, '\0')}), true);
+}
+
+TEST(CDFATest, ByteClasses) { ASSERT_EQ(CDFA(Expression("a.(b+c+d)*")).getClassCount(), 2); }
+
+TEST(CDFATest, MinimalSize) {
+  ASSERT_EQ(CDFA(Expression("(a+b)*.a.b.b")).getSize(), 4);
+  ASSERT_EQ(CDFA(Expression("a*+b.b")).getSize(), 5);
+}
+
+TEST(CDFATest, FinalStart) { ASSERT_EQ(Matcher(CDFA(Expression("a*.b*"))).checkWord(""), true); }
+
+TEST(NFATest, TransitionVisitor) {
+  NFA nfa(2, "ab");
+  nfa.addTransition({0, "ab", 1});
+  nfa.addTransition({1, "", 0});
+  std::vector<std::tuple<size_t, std::string, size_t>> visited;
+  nfa.forEachTransition([&visited](size_t from, std::string_view label, size_t to) {
+    visited.emplace_back(from, label, to);
+  });
+  ASSERT_EQ(visited, nfa.getTransitions());
+  ASSERT_EQ(visited.size(), 2);
+}
+
+TEST(DFATest, EmptyLanguage) {
+  DFA dfa((Expression("0")));
+  ASSERT_EQ(dfa.getSize(), 1);
+  ASSERT_EQ(dfa.checkWord(""), false);
+}
+
+TEST(DFATest, SubsetConstruction) {
+  ASSERT_EQ(CDFA(Expression("(a+b)*.a.(a+b).(a+b)")).getSize(), 8);
+  ASSERT_EQ(testMatcher("(a+b)*.a.(a+b).(a+b)", {"a", "aaa", "abb", "babb", "bbab", "aabab"}), true);
+}
+
+TEST(LazyDFATest, SameAsDFA) {
+  NFA nfa(Expression("(a+b)*.a.(a+b).(a+b).(a+b)"));
+  DFA dfa(nfa);
+  LazyDFA lazy(nfa, 256);
+  for (const char* word : {"", "a", "abbb", "babab", "aaaaaaab", "bbbbbbba", "ac"}) {
+    ASSERT_EQ(lazy.checkWord(word), dfa.checkWord(word));
+  }
+  ASSERT_GT(lazy.getFlushCount(), 0);
+}
+
+TEST(DFATest, ParallelSameAsSerial) {
+  NFA nfa(Expression("(a+b)*.a.(a+b).(a+b).(a+b).(a+b).(a+b).(a+b).(a+b)"));
+  DFA serial(nfa);
+  DFA parallel(nfa, {4});
+  ASSERT_EQ(parallel.getTransitions(), serial.getTransitions());
+  ASSERT_EQ(parallel.getFinalStates(), serial.getFinalStates());
+}
+
+TEST(NFASimulatorTest, Fallback) {
+  std::string str = "(a+b)*.a";
+  for (size_t index = 0; index < 69; ++index) {
+    str += ".(a+b)";
+  }
+  NFA nfa((Expression(str)));
+  ASSERT_THROW(DFA(nfa, {.stateLimit = 64}), std::length_error);
+  NFASimulator simulator(nfa);
+  ASSERT_GT(simulator.getSize(), 64);
+  std::string tail(69, 'b');
+  ASSERT_TRUE(simulator.checkWord("a" + tail));
+  ASSERT_TRUE(simulator.checkWord("bbaa" + tail));
+  ASSERT_FALSE(simulator.checkWord("b" + tail));
+  ASSERT_FALSE(simulator.checkWord("a" + tail.substr(1)));
+  ASSERT_FALSE(simulator.checkWord("a" + tail + "c"));
+  ASSERT_FALSE(simulator.checkWord(""));
+}
+
+TEST(MatcherTest, CheckWords) {
+  Matcher matcher(CDFA(Expression("(a+b)*.a.b.b")));
+  std::vector<std::string> words{"abb", "", "ab", "babb", "abbc", "aabb", "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbabb", "b"};
+  for (size_t count = 0; count < 40; ++count) {
+    words.push_back(std::string(count, 'a') + (count % 2 == 0 ? "bb" : "b"));
+  }
+  std::vector<std::string_view> views(words.begin(), words.end());
+  auto scalar = matcher.checkWords(views, Matcher::Kernel::Scalar);
+  ASSERT_EQ(matcher.checkWords(views, Matcher::Kernel::Interleaved), scalar);
+  ASSERT_EQ(matcher.checkWords(views, Matcher::Kernel::Gather), scalar);
+  for (size_t index = 0; index < views.size(); ++index) {
+    ASSERT_EQ(scalar[index], matcher.checkWord(views[index]));
+  }
+}
+
+TEST(ScannerTest, SearchInChunks) {
+  Scanner scanner(CDFA(Expression("a.b*.c")), Scanner::Mode::Search);
+  std::vector<size_t> ends;
+  auto onMatch = [&ends](size_t end) { ends.push_back(end); };
+  scanner.feed("xxabb", onMatch);
+  scanner.feed("c-ac", onMatch);
+  scanner.feed("\nabc", onMatch);
+  ASSERT_EQ(ends, std::vector<size_t>({6, 9, 13}));
+  ASSERT_EQ(scanner.getOffset(), 13);
+}
+
+TEST(ScannerTest, AnchoredFile) {
+  std::string path = testing::TempDir() + "scanner.txt";
+  std::ofstream(path) << "abababa";
+  Scanner scanner(DFA(Expression("(a.b)*")));
+  std::vector<size_t> ends;
+  scanner.feedFile(path, [&ends](size_t end) { ends.push_back(end); });
+  ASSERT_EQ(ends, std::vector<size_t>({0, 2, 4, 6}));
+  ASSERT_EQ(scanner.isAccepting(), false);
+}
+
+TEST(CDFATest, SaveLoad) {
+  std::string path = testing::TempDir() + "automaton.cdfa";
+  CDFA cdfa(Expression("(a+b)*.a.b.b"));
+  cdfa.save(path);
+
+  CDFA loaded = CDFA::load(path);
+  ASSERT_EQ(loaded.getSize(), cdfa.getSize());
+  ASSERT_EQ(loaded.getTransitions(), cdfa.getTransitions());
+  ASSERT_EQ(loaded.getFinalStates(), cdfa.getFinalStates());
+
+  Matcher matcher = Matcher::load(path);
+  ASSERT_EQ(matcher.getAlphabet(), "ab");
+  std::vector<std::string_view> words = {"", "abb", "babb", "abba", "abbc"};
+  ASSERT_EQ(matcher.checkWords(words), std::vector<bool>({false, true, true, false, false}));
+}
+
+TEST(CDFATest, LoadCorrupted) {
+  std::string path = testing::TempDir() + "corrupted.cdfa";
+  std::ofstream(path) << "FACDFA\r\n but not really";
+  ASSERT_THROW(Matcher::load(path), std::runtime_error);
+  ASSERT_THROW(CDFA::load(path + ".missing"), std::runtime_error);
+}
+
+TEST(MatcherTest, LoadCorrupted) {
+  std::string path = testing::TempDir() + "matcher.cdfa";
+  CDFA(Expression("(a+b)*.a.b.b")).save(path);
+  std::ifstream in(path, std::ios::binary);
+  std::string image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  uint64_t columnsOffset;
+  uint64_t tableOffset;
+  std::memcpy(&columnsOffset, image.data() + 48, sizeof(uint64_t));
+  std::memcpy(&tableOffset, image.data() + 56, sizeof(uint64_t));
+
+  auto loadModified = [&path](const std::string& data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+    return Matcher::load(path);
+  };
+  ASSERT_EQ(loadModified(image).checkWord("abb"), true);
+  ASSERT_THROW(loadModified(image.substr(0, image.size() / 2)), std::runtime_error);
+
+  std::string column = image;
+  uint16_t badColumn = 1000;
+  std::memcpy(column.data() + columnsOffset + 'a' * sizeof(uint16_t), &badColumn, sizeof(uint16_t));
+  ASSERT_THROW(loadModified(column), std::runtime_error);
+
+  for (uint32_t badOffset : {1u, 1u << 20}) {
+    std::string table = image;
+    std::memcpy(table.data() + tableOffset + sizeof(uint32_t), &badOffset, sizeof(uint32_t));
+    ASSERT_THROW(loadModified(table), std::runtime_error);
+  }
+}
+
+TEST(CodeGeneratorTest, ThreadedStates) {
+  std::ostringstream out;
+  CodeGenerator(CDFA(Expression("(a+b)*.c"))).generate(out, "matchC");
+  std::string code = out.str();
+  ASSERT_NE(code.find("bool matchC(const char* data, std::size_t size)"), std::string::npos);
+  ASSERT_NE(code.find("continue;"), std::string::npos);
+  ASSERT_NE(code.find("goto state_1;"), std::string::npos);
+  ASSERT_EQ(code.find("state_2"), std::string::npos);
+}
+
+TEST(CodeGeneratorTest, TrivialLanguages) {
+  std::ostringstream empty;
+  CodeGenerator(CDFA(Expression("0"))).generate(empty);
+  ASSERT_NE(empty.str().find("return false;"), std::string::npos);
+  ASSERT_EQ(empty.str().find("switch"), std::string::npos);
+}
+
+TEST(StaticExpressionTest, SameAsDFA) {
+  static_assert(static_regex<"(a+b)*.a.b.b">::matches("babb"));
+  static_assert(!static_regex<"(a+b)*.a.b.b">::matches("abba"));
+  static_assert(static_regex<"(a+b)*.a.b.b">::getSize() == 5);
+
+  using Pattern = StaticExpression<"(a.b + c)* . (1 + d) + 0.a">;
+  DFA dfa(Expression("(a.b + c)* . (1 + d) + 0.a"));
+  for (std::string word : {"", "a", "ab", "abc", "cabd", "dd", "abcab", "cdc", "x", "abd"}) {
+    ASSERT_EQ(Pattern::matches(word), dfa.checkWord(word));
+  }
+}
+
+TEST(PatternSetTest, AcceptIds) {
+  PatternSet patterns;
+  patterns.add(Expression("a.b*"));
+  patterns.add(Expression("(a+b)*.b"));
+  patterns.add(Expression("c"));
+  NFA nfa = patterns.toNFA();
+
+  CDFA cdfa(nfa);
+  Matcher matcher(cdfa);
+  ASSERT_EQ(matcher.matchPatterns("abb"), std::vector<size_t>({0, 1}));
+  ASSERT_EQ(matcher.matchPatterns("a"), std::vector<size_t>({0}));
+  ASSERT_EQ(matcher.matchPatterns("bab"), std::vector<size_t>({1}));
+  ASSERT_EQ(matcher.matchPatterns("c"), std::vector<size_t>({2}));
+  ASSERT_EQ(matcher.matchPatterns("ca"), std::vector<size_t>());
+
+  std::string path = testing::TempDir() + "patterns.cdfa";
+  cdfa.save(path);
+  ASSERT_EQ(Matcher::load(path).matchPatterns("abb"), std::vector<size_t>({0, 1}));
+  ASSERT_EQ(CDFA::load(path).getPatterns(cdfa.getSize() - 1), cdfa.getPatterns(cdfa.getSize() - 1));
+}
+
+TEST(PatternSetTest, MinimizeKeepsIds) {
+  PatternSet patterns;
+  patterns.add(Expression("a"));
+  patterns.add(Expression("b"));
+  ASSERT_EQ(CDFA(Expression("a+b")).getSize(), 3);
+  ASSERT_EQ(CDFA(patterns.toNFA()).getSize(), 4);
+  ASSERT_EQ(Matcher(DFA(patterns.toNFA(), {.threads = 4})).matchPatterns("b"), std::vector<size_t>({1}));
+}
+
+TEST(NFATest, LongEpsilonChain) {
+  const size_t size = 200000;
+  NFA nfa(size + 1, "a");
+  for (size_t vertex = 0; vertex + 1 < size; ++vertex) {
+    nfa.addTransition(vertex, "", vertex + 1);
+  }
+  nfa.addTransition(size - 1, "a", size);
+  nfa.addFinalState(size);
+
+  NFA res = nfa.throwEpsilon();
+  ASSERT_EQ(res.getTransitions().size(), size);
+  ASSERT_EQ(res.getFinalStates(), std::vector<size_t>({size}));
+}
+
+TEST(NFATest, InPlaceComposition) {
+  NFA ab(Expression("a.b"));
+  NFA c(Expression("c"));
+  NFA sum = ab + c;
+  ab += c;
+  ASSERT_EQ(ab.getTransitions(), sum.getTransitions());
+  ASSERT_EQ(ab.getAlphabet(), "abc");
+
+  NFA words(0, "");
+  for (const char* word : {"a.b", "b.a", "a.b.c", "c.a"}) {
+    NFA other((Expression(word)));
+    size_t size = words.getSize();
+    words += other;
+    ASSERT_EQ(words.getSize(), std::max<size_t>(size, 1) + other.getSize());
+  }
+  for (const char* word : {"ab", "ba", "abc", "ca"}) {
+    ASSERT_TRUE(DFA(words).checkWord(word));
+  }
+  ASSERT_FALSE(DFA(words).checkWord("a"));
+
+  NFA starred = *NFA(words);
+  starred += NFA(Expression("c"));
+  DFA mixed(starred);
+  for (const char* word : {"", "c", "baab", "abcca"}) {
+    ASSERT_TRUE(mixed.checkWord(word));
+  }
+  ASSERT_FALSE(mixed.checkWord("bac"));
+
+  DFA dfa(*(std::move(ab) * NFA(Expression("d"))));
+  for (const char* word : {"", "abd", "cd", "abdcdabd"}) {
+    ASSERT_TRUE(dfa.checkWord(word));
+  }
+  for (const char* word : {"ab", "c", "abcd", "dd"}) {
+    ASSERT_FALSE(dfa.checkWord(word));
+  }
+}
+
+TEST(ExpressionTest, EliminationOrders) {
+  CDFA cdfa(Expression("(a+b)*.a.b.b + b.a*"));
+  size_t indexLength = Expression(cdfa, Expression::Elimination::Index).toString().size();
+  for (auto order : {Expression::Elimination::Index, Expression::Elimination::Degree, Expression::Elimination::Weight}) {
+    Expression expression(cdfa, order);
+    ASSERT_LE(expression.toString().size(), indexLength);
+    ASSERT_EQ(CDFA(expression).getSize(), cdfa.getSize());
+    Matcher matcher{CDFA(expression)};
+    ASSERT_TRUE(matcher.checkWord("aabb") && matcher.checkWord("baa") && matcher.checkWord("b"));
+    ASSERT_FALSE(matcher.checkWord("abba") || matcher.checkWord("a") || matcher.checkWord(""));
+  }
+}
+
+TEST(ExpressionTest, HashConsing) {
+  Expression left("a.b + c*");
+  Expression right("c* + a.b");
+  ASSERT_EQ((left + left).toString(), "ab+c*");
+  ASSERT_EQ((left * right + left * right).toString(), "(ab+c*)(c*+ab)");
+  ASSERT_EQ(Matcher(CDFA(*(left * right))).checkWord("abcab"), true);
+}
+
+TEST(ExpressionTest, Derivatives) {
+  const auto derivatives = Expression::Construction::Derivatives;
+  for (const char* str : {"(a+b)*.a.(a+b).(a+b)", "a.b + a.c + (a.b + a.c)*", "(a*.b*)*.c + 0.a", "0", "1"}) {
+    Expression expression(str);
+    DFA thompson(expression.toNFA(), {.reduce = DeterminizeOptions::Reduction::Never});
+    DFA derived(expression, derivatives);
+    ASSERT_LE(derived.getSize(), thompson.getSize());
+    ASSERT_EQ(CDFA(expression, derivatives).minimize().getSize(), CDFA(thompson).minimize().getSize());
+    for (const char* word : {"", "a", "ab", "ac", "abab", "aabb", "baab", "abac", "bbc", "aaa"}) {
+      ASSERT_EQ(derived.checkWord(word), thompson.checkWord(word));
+    }
+  }
+  ASSERT_EQ(DFA(Expression("(a+b)*.a.(a+b)"), derivatives).getSize(), 4);
+}
+
+TEST(ExpressionTest, Glushkov) {
+  Expression expression("(a.b + a)*.(b + 1).a*");
+  NFA positions = expression.toNFA(Expression::Construction::Glushkov);
+  ASSERT_EQ(positions.getSize(), 6);
+  ASSERT_FALSE(positions.hasEpsilon());
+  ASSERT_TRUE(expression.toNFA().hasEpsilon());
+
+  DFA thompson(expression);
+  DFA glushkov(expression, Expression::Construction::Glushkov);
+  for (const char* word : {"", "a", "b", "ab", "ba", "aba", "abba", "abbab", "aabaa", "bb", "abab", "bab"}) {
+    ASSERT_EQ(glushkov.checkWord(word), thompson.checkWord(word));
+  }
+  ASSERT_EQ(CDFA(expression, Expression::Construction::Glushkov).minimize().getSize(), CDFA(thompson).minimize().getSize());
+  ASSERT_EQ(Expression("0").toNFA(Expression::Construction::Glushkov).getSize(), 0);
+}
+
+TEST(CDFATest, BooleanOperations) {
+  CDFA left(Expression("(a+b)*.a"));
+  CDFA right(Expression("a.(a+b+c)*"));
+  CDFA both = left & right;
+  CDFA either = left | right;
+  CDFA onlyLeft = left - right;
+  CDFA exactlyOne = left ^ right;
+  for (const char* word : {"", "a", "b", "c", "ba", "ab", "aba", "ac", "aca", "bab", "cb"}) {
+    bool inLeft = Matcher(left).checkWord(word);
+    bool inRight = Matcher(right).checkWord(word);
+    ASSERT_EQ(Matcher(both).checkWord(word), inLeft && inRight);
+    ASSERT_EQ(Matcher(either).checkWord(word), inLeft || inRight);
+    ASSERT_EQ(Matcher(onlyLeft).checkWord(word), inLeft && !inRight);
+    ASSERT_EQ(Matcher(exactlyOne).checkWord(word), inLeft != inRight);
+  }
+  ASSERT_EQ(both.getSize(), CDFA(Expression("a.(a+b)*.a + a")).getSize());
+  ASSERT_EQ((left ^ left).getFinalStates().size(), 0);
+  ASSERT_EQ((left ^ left).getSize(), 1);
+  ASSERT_GT(CDFA::combine(left, left, CDFA::Operation::SymmetricDifference, false).getSize(), 1);
+}
+
+TEST(CDFATest, EquivalenceAndInclusion) {
+  CDFA words(Expression("(a+b)*"));
+  CDFA nested(Expression("(a*.b*)*"));
+  CDFA even(Expression("((a+b).(a+b))*"));
+  ASSERT_TRUE(CDFA::equivalent(words, nested).holds);
+  ASSERT_TRUE(CDFA::equivalent(CDFA::combine(even, even, CDFA::Operation::Union, false), even).holds);
+
+  auto comparison = CDFA::equivalent(words, even);
+  ASSERT_FALSE(comparison.holds);
+  ASSERT_NE(Matcher(words).checkWord(comparison.counterexample), Matcher(even).checkWord(comparison.counterexample));
+  ASSERT_EQ(comparison.counterexample.size(), 1);
+
+  ASSERT_TRUE(CDFA::includes(words, even).holds);
+  comparison = CDFA::includes(even, CDFA(Expression("a.b + a.c")));
+  ASSERT_FALSE(comparison.holds);
+  ASSERT_EQ(comparison.counterexample, "ac");
+}
+
+TEST(AntichainCheckerTest, InclusionAndUniversality) {
+  AntichainChecker words(NFA(Expression("(a+b)*")));
+  ASSERT_TRUE(words.isUniversal().holds);
+  ASSERT_TRUE(AntichainChecker(NFA(Expression("(a*.b*)* + a"))).isUniversal().holds);
+  auto comparison = AntichainChecker(NFA(Expression("(a+b)*.a + 1"))).isUniversal();
+  ASSERT_FALSE(comparison.holds);
+  ASSERT_EQ(comparison.counterexample, "b");
+
+  AntichainChecker nth(NFA(Expression("(a+b)*.a.(a+b).(a+b).(a+b)")));
+  ASSERT_TRUE(nth.includes(NFA(Expression("(a+b)*.a.a.(a+b).(a+b) + (a+b)*.a.b.(a+b).(a+b)"))).holds);
+  comparison = nth.includes(NFA(Expression("(a+b)*.a.(a+b).(a+b)")));
+  ASSERT_FALSE(comparison.holds);
+  ASSERT_EQ(comparison.counterexample.size(), 3);
+  ASSERT_EQ(comparison.counterexample[0], 'a');
+  ASSERT_TRUE(words.includes(NFA(0, "ab")).holds);
+  ASSERT_FALSE(AntichainChecker(NFA(0, "ab")).includes(NFA(Expression("1"))).holds);
+}
+
+TEST(NFATest, BisimulationReduce) {
+  NFA nfa(9, "abcz");
+  for (const auto& [from, label, to] : std::vector<std::tuple<size_t, const char*, size_t>>{
+           {0, "a", 1}, {0, "a", 2}, {1, "b", 3}, {2, "b", 4}, {3, "c", 5}, {4, "c", 6}, {0, "z", 7}, {8, "a", 5}}) {
+    nfa.addTransition(from, label, to);
+  }
+  nfa.addFinalState(5);
+  nfa.addFinalState(6);
+  using Reduction = DeterminizeOptions::Reduction;
+  ASSERT_EQ(nfa.reduce().getSize(), 4);
+  ASSERT_EQ(DFA(nfa, {.reduce = Reduction::Always}).getSize(), 4);
+  ASSERT_EQ(DFA(nfa, {.reduce = Reduction::Never}).getSize(), 5);
+  ASSERT_EQ(DFA(nfa).getSize(), 5);
+  ASSERT_EQ(DFA(nfa, {.stateLimit = 4}).getSize(), 4);
+  ASSERT_THROW(DFA(nfa, {.stateLimit = 4, .reduce = Reduction::Never}), std::length_error);
+
+  NFA expression(Expression("a.b.c + a.b.d + b.b.c + b.b.d + a.a*.c"));
+  DFA reduced(expression, {.reduce = Reduction::Always});
+  Matcher matcher(reduced);
+  ASSERT_EQ(reduced.getSize(), CDFA(expression).getSize() - 1);
+  for (const char* word : {"abc", "abd", "bbc", "bbd", "ac", "aaac"}) {
+    ASSERT_TRUE(matcher.checkWord(word));
+  }
+  for (const char* word : {"", "ab", "bc", "aab", "abcd"}) {
+    ASSERT_FALSE(matcher.checkWord(word));
+  }
+
+  NFA blowup(Expression("(a+b)*.a.(a+b).(a+b).(a+b).(a+b).(a+b).(a+b).(a+b).(a+b)"));
+  DFA adaptive(blowup);
+  ASSERT_EQ(adaptive.getTransitions(), DFA(blowup, {.reduce = Reduction::Always}).getTransitions());
+  ASSERT_GT(DFA(blowup, {.reduce = Reduction::Never}).getSize(), adaptive.getSize());
+  ASSERT_THROW(DFA(blowup, {.stateLimit = 300}), std::length_error);
+}